@@ -82,8 +82,16 @@
  * See http://www.freertos.org/a00110.html.
  *----------------------------------------------------------*/
 
+#include "low_power.h"
+
 #define configUSE_PREEMPTION                    1
+#if APP_LOW_POWER
+/* 2: vPortSuppressTicksAndSleep() is provided by low_power.c (LPTMR). */
+#define configUSE_TICKLESS_IDLE                 2
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
+#else
 #define configUSE_TICKLESS_IDLE                 0
+#endif
 #define configCPU_CLOCK_HZ                      (SystemCoreClock)
 #define configTICK_RATE_HZ                      ((TickType_t)200)
 #define configMAX_PRIORITIES                    5
@@ -105,22 +113,42 @@
 #define configUSE_APPLICATION_TASK_TAG          0
 
 /* Memory allocation related definitions. */
-#define configSUPPORT_STATIC_ALLOCATION         0
+/* APP_STATIC_ALLOCATION creates every kernel object from static storage,
+see app_rtos.h. Dynamic allocation stays enabled so heap_4.c still builds,
+but nothing is allocated from the heap in that mode. */
+#ifndef APP_STATIC_ALLOCATION
+#define APP_STATIC_ALLOCATION                   0
+#endif
+#define configSUPPORT_STATIC_ALLOCATION         APP_STATIC_ALLOCATION
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
+#if APP_STATIC_ALLOCATION
+#define configTOTAL_HEAP_SIZE                   ((size_t)(64))
+#else
 #define configTOTAL_HEAP_SIZE                   ((size_t)(10240))
+#endif
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
 /* Hook function related definitions. */
 #define configUSE_IDLE_HOOK                     0
-#define configUSE_TICK_HOOK                     0
+#define configUSE_TICK_HOOK                     APP_LOW_POWER
 #define configCHECK_FOR_STACK_OVERFLOW          0
 #define configUSE_MALLOC_FAILED_HOOK            0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+/* APP_STATS selects the instrumentation build, see stats.c. */
+#ifndef APP_STATS
+#define APP_STATS                               0
+#endif
+#define configGENERATE_RUN_TIME_STATS           APP_STATS
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
+#if APP_STATS
+void stats_timer_init(void);
+unsigned long stats_timer_read(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() stats_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()        stats_timer_read()
+#endif
 
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
@@ -144,7 +172,7 @@
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
-#define INCLUDE_uxTaskGetStackHighWaterMark     0
+#define INCLUDE_uxTaskGetStackHighWaterMark     APP_STATS
 #define INCLUDE_xTaskGetIdleTaskHandle          0
 #define INCLUDE_eTaskGetState                   0
 #define INCLUDE_xTimerPendFunctionCall          1
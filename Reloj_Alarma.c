@@ -44,274 +44,350 @@
 #include "task.h"
 #include "semphr.h"
 
-#include "event_groups.h"
+#include "clock.h"
+#include "calendar.h"
+#include "low_power.h"
+#include "alarm_table.h"
+#include "vt100_render.h"
+#include "console.h"
+#include "command.h"
+#include "persist.h"
+#include "stats.h"
+#include "trace.h"
+#include "binlog.h"
+#include "timezone.h"
+#include "hrtimer.h"
+#include "boot_time.h"
+#include "alarm_out.h"
+#include "app_rtos.h"
+#include "app_config.h"
 
-EventGroupHandle_t g_time_events;
-
-/**type definition for recognizing which time element is passed*/
-typedef enum {
-    seconds_type, minutes_type, hours_type
-} time_types_t;
-
-/**type definition for containing the information to be shared between tasks*/
-typedef struct {
-    time_types_t time_type;
-    uint8_t value;
-} time_msg_t;
-
-#define TOP_SECONDS 60  /**the amount of seconds in 1 minute*/
-#define TOP_MINUTES 60  /**the amount of minutes in 1 hour*/
-#define TOP_HOURS 24    /**the amount of hours in 1 day*/
-
-#define HOURS_ALARM 22  /**alarm hour setup*/
-#define MINUTES_ALARM 1 /**alarm minutes setup*/
-#define SECONDS_ALARM 2 /**alarm seconds setup*/
+#define DEBUG 1
 
-#define HOURS_INIT 22   /**initial clock hours*/
-#define MINUTES_INIT 1  /**initial clock minutes*/
-#define SECONDS_INIT 58 /**initial clock seconds*/
+#if configMAX_PRIORITIES < 4
+#error "the task priorities of app_config.h need configMAX_PRIORITIES >= 4"
+#endif
+#if ZONE_ROW > RENDER_ROWS
+#error "the time zone views start below the rows of the renderer"
+#endif
+#if CRASH_ROW <= RENDER_ROWS
+#error "the crash report must be below the rows the renderer erases"
+#endif
+#if TEXT_ROW <= CRASH_ROW
+#error "the command output must scroll below the crash report"
+#endif
+#if RENDER_OUT_MAX > CONSOLE_RING_SIZE
+#error "one screen update must fit in the console ring"
+#endif
 
-#define HOURS_EVENT_BIT (1 << 0)    /**event group hours bit*/
-#define MINUTES_EVENT_BIT (1 << 1)  /**event group minutes bit*/
-#define SECONDS_EVENT_BIT (1 << 2)  /**event group seconds bit*/
+#if APP_HRTIMER
+#define COUNTDOWN_HEAP APP_TASK_HEAP(COUNTDOWN_TASK_STACK)
+#else
+#define COUNTDOWN_HEAP 0U
+#endif
 
-#define DEBUG 1
+/**
+ * Heap bytes of the dynamic build: the tasks, the screen mutex and the UART
+ * semaphores made by main, then the idle task, the timer task and the timer
+ * queue made by vTaskStartScheduler.
+ */
+#define APP_HEAP_BUDGET (APP_TASK_HEAP(ALARM_TASK_STACK) + APP_TASK_HEAP(CLOCK_TASK_STACK) \
+        + APP_TASK_HEAP(PRINT_TASK_STACK) + APP_TASK_HEAP(CONSOLE_TASK_STACK) \
+        + APP_TASK_HEAP(PERSIST_TASK_STACK) + APP_TASK_HEAP(COMMAND_TASK_STACK) \
+        + COUNTDOWN_HEAP + 3U * APP_SEMAPHORE_HEAP \
+        + APP_TASK_HEAP(configMINIMAL_STACK_SIZE) + APP_TASK_HEAP(configTIMER_TASK_STACK_DEPTH) \
+        + APP_SEMAPHORE_HEAP + configTIMER_QUEUE_LENGTH * 4U * sizeof(void *))
 
 /**RTOS elements declaration*/
-SemaphoreHandle_t minutes_semaphore;
-SemaphoreHandle_t hours_semaphore;
-SemaphoreHandle_t mutex_uart;
-static QueueHandle_t time_Queue;
+SemaphoreHandle_t mutex_screen;
+static TaskHandle_t print_handle;
+static TaskHandle_t alarm_handle;
 
-void alarm_task(void * args)
+/**
+ * Time mailbox: the print task notification value holds the latest clock
+ * second. Overwriting never blocks or fails, updates that arrive before the
+ * print task runs coalesce into one wake up, and one 32 bit word always
+ * gives a consistent h:m:s triple.
+ */
+static void publish_time(uint32_t clock_seconds)
 {
+    xTaskNotify(print_handle, clock_seconds, eSetValueWithOverwrite);
+}
 
-    /*
-     *It waits until the hours, minutes & seconds events happen
-     *then it takes the UART with a mutex to prevent collision with other tasks
-     * prints "ALARM!" and release the mutex of the UART
-     */
+#if APP_BINLOG
+/**
+ * Queues one binary log frame in place of a screen update, no lock is
+ * needed as a single console write is atomic. sent_event, unless it is
+ * TRACE_EVENT_COUNT, is traced with arg once the frame left the UART.
+ */
+static void log_event(binlog_id_t id, trace_event_t sent_event, uint32_t arg)
+{
+    uint8_t frame[BINLOG_FRAME_MAX];
+    size_t len;
 
-    for (;;)
+    len = binlog_encode(frame, id, xTaskGetTickCount(), &arg);
+#if APP_TRACE
+    if (sent_event < TRACE_EVENT_COUNT)
+    {
+        console_write_traced((const char *)frame, len, sent_event, arg);
+        return;
+    }
+#endif
+    console_write((const char *)frame, len);
+}
+#else
+/**
+ * Queues the pending screen changes, mutex_screen must be held. sent_event
+ * is traced with arg once the bytes left the UART. The shadow of the
+ * renderer already holds the changes, so when bytes are lost, a write
+ * rejected here or earlier frames cut by drop oldest, the whole screen is
+ * redrawn.
+ */
+static void screen_update(trace_event_t sent_event, uint32_t arg)
+{
+    static char out[RENDER_OUT_MAX];
+    static uint32_t dropped;    /**console drops seen by the previous update*/
+    console_stats_t console;
+    size_t accepted;
+    size_t len;
+
+    console_get_stats(&console);
+    if (console.dropped != dropped)
+    {
+        dropped = console.dropped;
+        vt100_render_invalidate();
+    }
+    /**a full repaint takes more than one flush, the last one is traced*/
+    while (0 != (len = vt100_render_flush(out, sizeof(out))))
     {
-        xEventGroupWaitBits(g_time_events,
-        SECONDS_EVENT_BIT | MINUTES_EVENT_BIT | HOURS_EVENT_BIT,
-                            pdTRUE,
-                            pdTRUE,
-                            portMAX_DELAY);
-        xSemaphoreTake(mutex_uart, portMAX_DELAY);
-
-        PRINTF("\033[2J"); /**UART clear screen VT100 command*/
-        PRINTF("ALARM! \033[5;10H");
-        xSemaphoreGive(mutex_uart);
+#if APP_TRACE
+        accepted = vt100_render_pending() ? console_write(out, len)
+                : console_write_traced(out, len, sent_event, arg);
+#else
+        accepted = console_write(out, len);
+#endif
+        if (accepted < len)
+        {
+            vt100_render_invalidate();
+            break;
+        }
     }
+}
+#endif /* APP_BINLOG */
 
+/**
+ * Alarm dispatch: clock_task hands the clock second straight to alarm_task,
+ * the highest priority task, so it runs as soon as clock_task notifies it.
+ * Worst case from the second boundary to alarm_task running:
+ *   - the tick or RTC interrupt and one switch into clock_task, plus the
+ *     longest critical section of a lower task (alarm_table_rebase of a
+ *     full table is the longest, O(ALARM_TABLE_SIZE));
+ *   - one O(log ALARM_TABLE_SIZE) alarm_table_poll per due alarm;
+ *   - one switch into alarm_task.
+ * Drawing then waits at most for print_task's mutex_screen section (one
+ * render and its console ring copies) or for one line of console_put_line,
+ * shortened by priority inheritance.
+ * No step depends on the tick rate or on idle time. TRACE_PATH_DISPATCH
+ * measures this path and the simulation harness checks it.
+ */
+static void dispatch_alarm(uint32_t clock_seconds)
+{
+    xTaskNotify(alarm_handle, clock_seconds, eSetValueWithOverwrite);
 }
 
-void print_task(void * args)
+void alarm_task(void * args)
 {
+
     /*
-     *The value of each unit it's updated
-     *depending on the time_type received by the Queue.
+     *It waits until clock_task dispatches an alarm
+     *then it takes the screen with a mutex to prevent collision with other tasks
+     * draws "ALARM!" and release the mutex of the screen.
+     *The console queues the bytes, the UART is never waited on.
+     *The buzzer and LED pattern is played by interrupts from then on.
      */
-    static time_msg_t *message;
-    static uint8_t sec = SECONDS_INIT;
-    static uint8_t min = MINUTES_INIT;
-    static uint8_t hr = HOURS_INIT;
+    uint32_t clock_seconds;
 
-    PRINTF("\033[2J"); /**UART clear screen VT100 command*/
+#if APP_ALARM_OUT
+    alarm_out_init();
+#endif
     for (;;)
     {
-#if DEBUG
-        xQueueReceive(time_Queue, &message, portMAX_DELAY);
+        xTaskNotifyWait(0, 0, &clock_seconds, portMAX_DELAY);
+        trace_point(TRACE_ALARM_RECV, clock_seconds);
+#if APP_ALARM_OUT
+        alarm_out_play(ALARM_OUT_PATTERN);
+#endif
+#if APP_BINLOG
+        log_event(BINLOG_ALARM, TRACE_ALARM_SENT, clock_seconds);
+#else
+        stats_semaphore_take(mutex_screen, portMAX_DELAY, STATS_WAIT_SCREEN);
+        vt100_render_line(ALARM_ROW, ALARM_COL, "ALARM!");
+        screen_update(TRACE_ALARM_SENT, clock_seconds);
+        xSemaphoreGive(mutex_screen);
 #endif
-        switch (message->time_type)
-        {
-            case seconds_type:
-                sec = message->value;
-            break;
-            case minutes_type:
-                min = message->value;
-            break;
-            case hours_type:
-                hr = message->value;
-            break;
-            default:
-            break;
-        }
-        /**To prevent errors between task
-         * a mutex is used for the use of the UART
-         */
-        xSemaphoreTake(mutex_uart, portMAX_DELAY);
-        PRINTF("%d : %d : %d hrs \033[3;10H", hr, min, sec);
-        xSemaphoreGive(mutex_uart);
-        /**Free memory to prevent overflow
-         */
-        vPortFree(message);
     }
 
 }
 
-void seconds_task(void *args)
+#if !APP_BINLOG
+#if APP_ALARM_OUT
+/**the alarm message follows the output, it goes away with a stop or auto-stop*/
+static const char *alarm_text(void)
 {
-    static time_msg_t *message;
-    static TickType_t LastTimeAwake;
-    static uint8_t seconds = SECONDS_INIT;
-    /*
-     * If the alarm is equal to the minutes and hours of
-     *initialization, then the seconds of initialization are checked.
-     */
-    if ((MINUTES_EVENT_BIT | HOURS_EVENT_BIT)
-            == xEventGroupGetBits(g_time_events))
+    switch (alarm_out_state())
     {
-        if (SECONDS_ALARM == seconds)
-        {
-            /**if the seconds correspond with that of the alarm, the seconds bit is set*/
-            xEventGroupSetBits(g_time_events, SECONDS_EVENT_BIT);
-        }
+        case ALARM_OUT_PLAYING:
+            return "ALARM!";
+        case ALARM_OUT_SNOOZED:
+            return "SNOOZE";
+        default:
+            return "";
     }
-#if 0
-    QueueHandle_t * seconds_handler = (QueueHandle_t*)(args);
+}
 #endif
-    /*
-     * This task wakes up every second.
-     * it increments the value of seconds and if
-     * it gets to 0 again.
-     * Sets up an event to increase the value of minutes.
-     * Reserves memory for the message and sends it.
-     *
-     */
-    for (;;)
-    {
-        LastTimeAwake = xTaskGetTickCount();
-        if (seconds < TOP_SECONDS - 1)
-        {
-            seconds++;
 
-        } else
-        {
-            seconds = 0;
-            xSemaphoreGive(minutes_semaphore);
-        }
+#define ZONE_ROWS (RENDER_ROWS - ZONE_ROW + 1)  /**zones shown at once*/
 
-        if ((MINUTES_EVENT_BIT | HOURS_EVENT_BIT)
-                == xEventGroupGetBits(g_time_events))
+/**
+ * Formats the zones picked by the 'zones' command, one per row, and blanks
+ * the rows left over. Zones that are not shown cost nothing.
+ */
+static void format_zones(uint32_t clock_seconds, char text[][RENDER_COLS])
+{
+    calendar_date_t date;
+    clock_hms_t time;
+    uint32_t shown = timezone_shown();
+    uint32_t local;
+    bool summer;
+    uint8_t zone;
+    uint8_t row = 0;
+
+    for (zone = 0; (zone < timezone_count()) && (row < ZONE_ROWS); zone++)
+    {
+        if (shown & (1UL << zone))
         {
-            if (SECONDS_ALARM == seconds)
-            {
-                xEventGroupSetBits(g_time_events, SECONDS_EVENT_BIT);
-            }
+            local = timezone_local(zone, clock_seconds, &summer);
+            calendar_from_days(local / SECONDS_PER_DAY, &date);
+            clock_to_hms(local, &time);
+            snprintf(text[row++], RENDER_COLS, "%-4s %s %04d-%02d-%02d %02d:%02d:%02d%s",
+                     timezone_name(zone), calendar_weekday_name(date.weekday),
+                     date.year, date.month, date.day, time.hours, time.minutes,
+                     time.seconds, summer ? " DST" : "");
         }
-
-        message = pvPortMalloc(sizeof(time_msg_t));
-        message->time_type = seconds_type;
-        message->value = seconds;
-#if DEBUG
-        xQueueSend(time_Queue, &message, 0);    /**the message is sent to the shared queue*/
-#endif
-        vTaskDelayUntil(&LastTimeAwake, pdMS_TO_TICKS(1000));
-
     }
-
+    for (; row < ZONE_ROWS; row++)
+    {
+        text[row][0] = '\0';
+    }
 }
+#endif /* !APP_BINLOG */
 
-void minutes_task(void *arg)
+void print_task(void * args)
 {
-    static time_msg_t *message;
-    static uint8_t minutes = MINUTES_INIT;
     /*
-     * If the alarm is equal to the hours of
-     *initialization, then the minutes of initialization are checked.
+     *Every wake up reads the newest time from the mailbox,
+     *it is drawn into the screen frame and only the
+     *characters that changed are sent to the UART.
      */
-    if (HOURS_EVENT_BIT == xEventGroupGetBits(g_time_events))
+#if !APP_BINLOG
+    static clock_hms_t time;
+    static calendar_date_t date;
+    static char text[RENDER_OUT_MAX];
+    static char date_text[RENDER_COLS];
+    static char zone_text[ZONE_ROWS][RENDER_COLS];
+    uint8_t row;
+    size_t len;
+#endif
+    uint32_t clock_seconds = 0;
+
+#if APP_BINLOG
+    /**the decoder learns the tick rate from the first frame*/
+    log_event(BINLOG_START, TRACE_EVENT_COUNT, configTICK_RATE_HZ);
+#else
+    stats_semaphore_take(mutex_screen, portMAX_DELAY, STATS_WAIT_SCREEN);
+    len = vt100_render_init(text, sizeof(text)); /**UART clear screen VT100 command*/
+    /**command output scrolls below the clock and the crash report*/
+    len += vt100_render_text_area(&text[len], sizeof(text) - len, TEXT_ROW);
+    if (console_write(text, len) < len)
     {
-        if (MINUTES_ALARM == minutes)
-        {
-            xEventGroupSetBits(g_time_events, MINUTES_EVENT_BIT);
-        }
+        vt100_render_invalidate();
     }
-    /*
-     * This task wakes up every minute waiting for the 60 seconds event
-     * it increments the value of minutes and if
-     * it gets to 0 again.
-     * Sets up an event to increase the value of hours.
-     * Reserves memory for the message and sends it.
-     *
-     */
+    xSemaphoreGive(mutex_screen);
+#endif
     for (;;)
     {
-        xSemaphoreTake(minutes_semaphore, portMAX_DELAY);   /**if the minutes semaphore is free to be taken,*/
-        /**the following instructions will be performed*/
-
-        if (minutes < TOP_MINUTES - 1)  /**if current minutes variable doesn't exceed the minutes limit,*/
-        {
-            minutes++;  /**then current minutes variable is increased*/
-        } else  /**if current minutes variable has exceeded the minutes limit,*/
-        {
-            minutes = 0;    /**as an hour has passed, the minutes variable is reset*/
-            xSemaphoreGive(hours_semaphore);    /**if an hour has passed, then the hour semaphore is released*/
-        }
-        if (HOURS_EVENT_BIT == xEventGroupGetBits(g_time_events))  /**if previously the hours event bit had been set,*/
+#if DEBUG
+        xTaskNotifyWait(0, 0, &clock_seconds, portMAX_DELAY);
+#endif
+        trace_point(TRACE_PRINT_RECV, clock_seconds);
+#if APP_BINLOG
+        /**the host decoder formats the date and time*/
+        log_event(BINLOG_TIME, TRACE_TIME_SENT, clock_seconds);
+        boot_mark(BOOT_FIRST_SECOND);
+#else
+        clock_to_hms(clock_seconds, &time);
+        calendar_from_days(clock_seconds / SECONDS_PER_DAY, &date);
+        /**To prevent errors between task
+         * a mutex is used for the use of the screen
+         */
+        snprintf(date_text, sizeof(date_text), "%s %04d-%02d-%02d",
+                 calendar_weekday_name(date.weekday), date.year, date.month,
+                 date.day);
+        snprintf(text, sizeof(text), "%d : %d : %d hrs", time.hours,
+                 time.minutes, time.seconds);
+        format_zones(clock_seconds, zone_text);
+        stats_semaphore_take(mutex_screen, portMAX_DELAY, STATS_WAIT_SCREEN);
+        vt100_render_line(DATE_ROW, DATE_COL, date_text); /**only sent when the day changes*/
+        vt100_render_line(TIME_ROW, TIME_COL, text);
+        for (row = 0; row < ZONE_ROWS; row++)
         {
-            if (MINUTES_ALARM == minutes)   /**if the current minute coincides with the alarm minutes,*/
-            {
-                xEventGroupSetBits(g_time_events, MINUTES_EVENT_BIT);   /**then the corresponding minutes bit is set*/
-            }
+            vt100_render_line(ZONE_ROW + row, ZONE_COL, zone_text[row]);
         }
+#if APP_ALARM_OUT
+        vt100_render_line(ALARM_ROW, ALARM_COL, alarm_text());
+#endif
+        screen_update(TRACE_TIME_SENT, clock_seconds);
+        xSemaphoreGive(mutex_screen);
+        boot_mark(BOOT_FIRST_SECOND);
+#endif
+    }
 
-        message = pvPortMalloc(sizeof(time_msg_t)); /**memory is reserved for the message to be sent*/
-        message->time_type = minutes_type;  /**in the message, the time type is established as minutes*/
-        message->value = minutes;   /**in the message, the value to be passed is the current minutes variable*/
-#if DEBUG
-        xQueueSend(time_Queue, &message, 0);    /**the message is sent to the shared queue*/
+}
 
-#endif
+/**fires every alarm of the table that is due at the given clock second*/
+static void check_alarms(uint32_t clock_seconds)
+{
+    while (ALARM_NONE != alarm_table_poll(clock_seconds))
+    {
+        trace_point(TRACE_ALARM_SET, clock_seconds);
+        dispatch_alarm(clock_seconds);
     }
 }
 
-void hours_task(void * args)
+void clock_task(void *args)
 {
+    uint32_t clock_seconds = clock_now();
+
+    /**an alarm set at the initial time is fired at once, and the time is
+     * shown without waiting for the next second boundary*/
+    check_alarms(clock_seconds);
+#if DEBUG
+    publish_time(clock_seconds);
+#endif
     /*
-     * This task wakes up every hour waiting for the 60 minutes event
-     * it increments the value of hours and if
-     * it gets to 0 again.
-     * Sets the hour event bit
-     * Reserves memory for the message and sends it.
-     *
+     * The time itself is kept by the clock source, this task only
+     * wakes at each second boundary to check the next due alarm
+     * and post the new time to the mailbox.
      */
-    static time_msg_t *message;
-
-    static uint8_t hours = HOURS_INIT;
-    if (HOURS_ALARM == hours)
-    {
-        xEventGroupSetBits(g_time_events, HOURS_EVENT_BIT);
-
-    }
     for (;;)
     {
-        xSemaphoreTake(hours_semaphore, portMAX_DELAY);
-        /**if the hours semaphore is could be taken, i.e. it was
-         * free or released, then the following
-         * operations will be performed*/
-
-        if (hours < TOP_HOURS - 1) /**if the current hours is still less than the hours limit,*/
-        {
-            hours++; /**then the hours are increased*/
-        } else /**if the current hours exceed the hours limit,*/
-        {
-            hours = 0; /**the current hours variable is reset to 0*/
-        }
-        if (HOURS_ALARM == hours) /**if current hour coincides with the alarm hour,*/
-        {
-            xEventGroupSetBits(g_time_events, HOURS_EVENT_BIT); /**then the corresponding hour event group bit is set*/
-
-        }
+        clock_seconds = clock_wait_second();
+        trace_point(TRACE_CLOCK_WAKE, clock_seconds);
+        check_alarms(clock_seconds);
 
-        message = pvPortMalloc(sizeof(time_msg_t)); /**memory is reserved for the message to be sent*/
-        message->time_type = hours_type; /**in the message, the time type is established as hour*/
-        message->value = hours; /**in the message, the value to be passed is the current hour variable*/
 #if DEBUG
-        xQueueSend(time_Queue, &message, 0); /**the message is sent to the shared queue*/
+        publish_time(clock_seconds);   /**the newest time replaces the previous one*/
+        trace_point(TRACE_TIME_POST, clock_seconds);
 #endif
     }
 
@@ -319,49 +395,88 @@ void hours_task(void * args)
 
 int main(void)
 {
+    uint32_t start_seconds;
+    alarm_t default_alarm;
+    bool resumed;
 
+    boot_mark(BOOT_MAIN);
     /* Init board hardware. */
     BOARD_InitBootPins();
     BOARD_InitBootClocks();
-    BOARD_InitBootPeripherals();
+    boot_mark(BOOT_CLOCKS);
     /* Init FSL debug console. */
     BOARD_InitDebugConsole();
 
-    PRINTF("\033[2J"); /**clear screen VT100 command*/
+    /**the time base and the alarms resume from the flash log, if any*/
+    start_seconds = calendar_to_days(YEAR_INIT, MONTH_INIT, DAY_INIT) * SECONDS_PER_DAY
+            + HMS_TO_SECONDS(HOURS_INIT, MINUTES_INIT, SECONDS_INIT);
+    resumed = persist_init(&start_seconds);
+    clock_init(start_seconds);
+    /**a running RTC keeps its own time, the alarms start from the clock's*/
+    alarm_table_init(clock_now());
+    if (resumed)
+    {
+        persist_restore_alarms();
+    } else
+    {
+        /**first boot, the alarm table starts with the default daily alarm*/
+        default_alarm.seconds_of_day = HMS_TO_SECONDS(HOURS_ALARM, MINUTES_ALARM,
+                                                      SECONDS_ALARM);
+        default_alarm.date = ALARM_REPEATING;
+        default_alarm.weekdays = CALENDAR_EVERY_DAY;
+        default_alarm.enabled = true;
+        alarm_table_add(&default_alarm);
+    }
+    boot_mark(BOOT_RESTORED);
+
+    /**
+     * RTOS elements creation: every object a task uses exists before the
+     * first task is created, and a failed creation stops at configASSERT
+     */
+#if !APP_STATIC_ALLOCATION
+    /**everything up to the scheduler start fits, or it stops here*/
+    configASSERT(APP_HEAP_BUDGET <= xPortGetFreeHeapSize());
+#endif
+    APP_MUTEX_CREATE(mutex_screen); /**mutex created in order to protect the screen*/
+    console_init(CONSOLE_POLICY); /**console ring buffer in front of the uart*/
+    console_port_init(); /**uart semaphores and receive ring*/
 
-    /**RTOS elements creation*/
-    time_Queue = xQueueCreate(1, sizeof(void*)); /**IPC queue created with the size of a void pointer*/
-    minutes_semaphore = xSemaphoreCreateBinary(); /**binary semaphore created for the minutes*/
-    hours_semaphore = xSemaphoreCreateBinary(); /**binary semaphore created for the hours*/
-    mutex_uart = xSemaphoreCreateMutex(); /**mutex created in order to protect the uart*/
+    /**alarm task created with the highest priority, alarms are dispatched to it*/
+    APP_TASK_CREATE(alarm_task, "Alarm", ALARM_TASK_STACK, ALARM_TASK_PRIORITY,
+                    &alarm_handle);
 
-     /**seconds task created with the highest priority as it is the most frequent task*/
-    xTaskCreate(seconds_task, "Seconds", configMINIMAL_STACK_SIZE + 200,
-                (void*) (time_Queue), configMAX_PRIORITIES - 1, NULL);
+    /**clock task created right below, it owns the time*/
+    APP_TASK_CREATE(clock_task, "Clock", CLOCK_TASK_STACK, CLOCK_TASK_PRIORITY, NULL);
 
-    /**minutes task created*/
-    xTaskCreate(minutes_task, "Minutes", configMINIMAL_STACK_SIZE + 200,
-                (void*) (time_Queue), configMAX_PRIORITIES - 3, NULL);
+    /**print task created*/
+    APP_TASK_CREATE(print_task, "Print", PRINT_TASK_STACK, PRINT_TASK_PRIORITY,
+                    &print_handle);
 
-    /**hours task created*/
-    xTaskCreate(hours_task, "Hours", configMINIMAL_STACK_SIZE + 200, NULL,
-    configMAX_PRIORITIES - 4,
-                NULL);
+    /**console task created at the lowest priority, it only drains the uart ring*/
+    APP_TASK_CREATE(console_task, "Console", CONSOLE_TASK_STACK, tskIDLE_PRIORITY, NULL);
 
-    /**alarm task created*/
-    xTaskCreate(alarm_task, "Alarm", configMINIMAL_STACK_SIZE + 200, NULL,
-    configMAX_PRIORITIES - 5,
-                NULL);
+    /**persist task created at the lowest priority, flash writes never delay the clock*/
+    APP_TASK_CREATE(persist_task, "Persist", PERSIST_TASK_STACK, tskIDLE_PRIORITY, NULL);
 
-    /**print task created*/
-    xTaskCreate(print_task, "Print", configMINIMAL_STACK_SIZE + 200, NULL,
-    configMAX_PRIORITIES - 6,
-                NULL);
+    /**command task created at the lowest priority, it sets the time and alarms at runtime*/
+    APP_TASK_CREATE(command_task, "Command", COMMAND_TASK_STACK, tskIDLE_PRIORITY, NULL);
+
+#if APP_HRTIMER
+    /**countdown task reports expired countdowns, it starts their counter itself*/
+    APP_TASK_CREATE(countdown_task, "Countdown", COUNTDOWN_TASK_STACK,
+                    COUNTDOWN_TASK_PRIORITY, NULL);
+#endif
+
+    /**only the timers the first tick depends on are started before the scheduler*/
+#if APP_TRACE
+    trace_timer_init();
+#endif
 
-    /**the shared bits event group is created*/
-    g_time_events = xEventGroupCreate();
+    /**the LPTMR times the tickless idle periods*/
+    low_power_init();
 
     /**RTOS scheduler takes tasks control from now on*/
+    boot_mark(BOOT_SCHEDULER);
     vTaskStartScheduler();
 
     while (1)
@@ -0,0 +1,165 @@
+/**
+ * @file    alarm_out.c
+ * @brief   Pattern table and the player state machine.
+ *
+ * The player state is shared by the tasks that start or stop it and the
+ * step timer interrupt that advances it, so it is only changed in critical
+ * sections. The interrupt does all the timing: each step programs the next
+ * timeout, and a snooze is a run of silent timeouts of at most
+ * ALARM_OUT_TIMER_MAX_MS.
+ */
+
+#include "alarm_out.h"
+
+#if APP_ALARM_OUT
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define MS_PER_SECOND 1000U
+
+static const alarm_step_t beeps[] = {
+    { 2000, 100, true }, { 0, 100, false },
+    { 2000, 100, true }, { 0, 100, false },
+    { 2000, 100, true }, { 0, 100, false },
+    { 2000, 100, true }, { 0, 600, false }
+};
+
+static const alarm_step_t chirp[] = {
+    { 1000, 150, true }, { 1500, 150, true }, { 2000, 150, true },
+    { 0, 550, false }
+};
+
+static const alarm_step_t blink[] = {
+    { 0, 250, true }, { 0, 750, false }
+};
+
+/**type definition for one row of the pattern table*/
+typedef struct {
+    const alarm_step_t *steps;
+    uint8_t count;
+} pattern_t;
+
+#define PATTERN(steps) { steps, sizeof(steps) / sizeof(steps[0]) }
+static const pattern_t patterns[ALARM_PATTERN_COUNT] = {
+    PATTERN(beeps),
+    PATTERN(chirp),
+    PATTERN(blink)
+};
+
+static volatile alarm_out_state_t state = ALARM_OUT_IDLE;
+static const pattern_t *playing = &patterns[0];
+static uint8_t step;
+static uint32_t rang_ms;        /**time played since the start or the snooze*/
+static uint32_t snooze_left_ms;
+
+/**outputs the current step and times it, called in a critical section*/
+static void start_step(void)
+{
+    const alarm_step_t *current = &playing->steps[step];
+
+    alarm_out_port_tone(current->tone_hz);
+    alarm_out_port_led(current->led);
+    alarm_out_port_timer(current->ms);
+    rang_ms += current->ms;
+}
+
+/**output off and nothing pending, called in a critical section*/
+static void silence(void)
+{
+    alarm_out_port_timer(0);
+    alarm_out_port_tone(0);
+    alarm_out_port_led(false);
+}
+
+/**times the next part of a snooze, called in a critical section*/
+static void snooze_wait(void)
+{
+    uint32_t chunk = (snooze_left_ms > ALARM_OUT_TIMER_MAX_MS)
+            ? ALARM_OUT_TIMER_MAX_MS : snooze_left_ms;
+
+    snooze_left_ms -= chunk;
+    alarm_out_port_timer(chunk);
+}
+
+void alarm_out_init(void)
+{
+    alarm_out_port_init();
+    silence();
+}
+
+void alarm_out_play(alarm_pattern_t pattern)
+{
+    taskENTER_CRITICAL();
+    playing = &patterns[pattern % ALARM_PATTERN_COUNT];
+    step = 0;
+    rang_ms = 0;
+    state = ALARM_OUT_PLAYING;
+    start_step();
+    taskEXIT_CRITICAL();
+}
+
+bool alarm_out_snooze(void)
+{
+    bool snoozed = false;
+
+    taskENTER_CRITICAL();
+    if (ALARM_OUT_PLAYING == state)
+    {
+        silence();
+        state = ALARM_OUT_SNOOZED;
+        snooze_left_ms = ALARM_OUT_SNOOZE_S * MS_PER_SECOND;
+        snooze_wait();
+        snoozed = true;
+    }
+    taskEXIT_CRITICAL();
+    return snoozed;
+}
+
+void alarm_out_stop(void)
+{
+    taskENTER_CRITICAL();
+    silence();
+    state = ALARM_OUT_IDLE;
+    taskEXIT_CRITICAL();
+}
+
+alarm_out_state_t alarm_out_state(void)
+{
+    return state;
+}
+
+void alarm_out_step_from_isr(void)
+{
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+
+    switch (state)
+    {
+        case ALARM_OUT_PLAYING:
+            if (rang_ms >= ALARM_OUT_TIMEOUT_S * MS_PER_SECOND)
+            {
+                silence();  /**auto-stop, nobody turned it off*/
+                state = ALARM_OUT_IDLE;
+                break;
+            }
+            step = (uint8_t)((step + 1U) % playing->count);
+            start_step();
+        break;
+        case ALARM_OUT_SNOOZED:
+            if (snooze_left_ms)
+            {
+                snooze_wait();
+                break;
+            }
+            step = 0;
+            rang_ms = 0;
+            state = ALARM_OUT_PLAYING;
+            start_step();
+        break;
+        default:
+        break;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+}
+
+#endif /* APP_ALARM_OUT */
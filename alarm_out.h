@@ -0,0 +1,90 @@
+/**
+ * @file    alarm_out.h
+ * @brief   Alarm output: buzzer tone and LED pattern player.
+ *
+ * A pattern is a table of steps, each a tone (or silence), an LED state
+ * and a duration, played in a loop. The board layer drives the buzzer
+ * with a PWM channel and times every step with a one-shot timer whose
+ * interrupt starts the next step, so no task runs while a pattern plays.
+ * The player stops by itself after ALARM_OUT_TIMEOUT_S; a snooze silences
+ * it and the interrupt restarts it ALARM_OUT_SNOOZE_S later.
+ */
+
+#ifndef ALARM_OUT_H_
+#define ALARM_OUT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**enables the buzzer and LED output, 0 keeps the screen message only*/
+#ifndef APP_ALARM_OUT
+#define APP_ALARM_OUT 1
+#endif
+
+#ifndef ALARM_OUT_TIMEOUT_S
+#define ALARM_OUT_TIMEOUT_S 60      /**ringing time before the auto-stop*/
+#endif
+#ifndef ALARM_OUT_SNOOZE_S
+#define ALARM_OUT_SNOOZE_S 300      /**silence of a snooze*/
+#endif
+#ifndef ALARM_OUT_PATTERN
+#define ALARM_OUT_PATTERN ALARM_PATTERN_BEEPS   /**pattern of the alarms*/
+#endif
+
+/**one step of a pattern*/
+typedef struct {
+    uint16_t tone_hz;   /**0 is silence*/
+    uint16_t ms;        /**duration*/
+    bool led;
+} alarm_step_t;
+
+/**patterns of the table*/
+typedef enum {
+    ALARM_PATTERN_BEEPS,    /**four short beeps and a pause*/
+    ALARM_PATTERN_CHIRP,    /**rising three tone chirp*/
+    ALARM_PATTERN_BLINK,    /**LED only, for quiet hours*/
+    ALARM_PATTERN_COUNT
+} alarm_pattern_t;
+
+/**what the player is doing*/
+typedef enum {
+    ALARM_OUT_IDLE,
+    ALARM_OUT_PLAYING,
+    ALARM_OUT_SNOOZED
+} alarm_out_state_t;
+
+#if APP_ALARM_OUT
+
+/**prepares the PWM, the LED and the step timer, called by alarm_task when it starts*/
+void alarm_out_init(void);
+
+/**starts a pattern from its first step, restarting one already playing*/
+void alarm_out_play(alarm_pattern_t pattern);
+
+/**silences a playing pattern and plays it again after the snooze time*/
+bool alarm_out_snooze(void);
+
+/**stops the output, playing or snoozed*/
+void alarm_out_stop(void);
+
+alarm_out_state_t alarm_out_state(void);
+
+/**called by the board layer from the step timer interrupt*/
+void alarm_out_step_from_isr(void);
+
+/**board layer: buzzer tone, 0 Hz is silence*/
+void alarm_out_port_init(void);
+void alarm_out_port_tone(uint16_t hz);
+void alarm_out_port_led(bool on);
+/**
+ * One-shot step timer: alarm_out_step_from_isr is called after ms
+ * milliseconds, at most ALARM_OUT_TIMER_MAX_MS; 0 cancels it. Called in
+ * a critical section or from the timer interrupt.
+ */
+void alarm_out_port_timer(uint32_t ms);
+
+#define ALARM_OUT_TIMER_MAX_MS 60000U
+
+#endif /* APP_ALARM_OUT */
+
+#endif /* ALARM_OUT_H_ */
@@ -0,0 +1,111 @@
+/**
+ * @file    alarm_out_ftm.c
+ * @brief   FTM3 PWM buzzer, red LED and PIT step timer of the alarm output.
+ *
+ * The buzzer sits on PTC10, FTM3 channel 6, driven with an edge aligned 50%
+ * PWM whose period is the tone; silence is a 0% duty cycle, so the pin
+ * stays low. FTM3 counts the bus clock divided by 4, which reaches tones
+ * from ~230 Hz up. The LED is the red one of the RGB LED, PTB22, active
+ * low. PIT channel 3 times each step as a one-shot and its interrupt calls
+ * the player, which loads the next step: one interrupt per step, no task.
+ */
+
+#include "alarm_out.h"
+
+#if APP_ALARM_OUT
+
+#include "MK64F12.h"
+#include "FreeRTOS.h"
+#include "board.h"
+#include "fsl_clock.h"
+#include "fsl_port.h"
+#include "fsl_gpio.h"
+#include "fsl_pit.h"
+
+#define BUZZER_PORT PORTC
+#define BUZZER_PIN 10U
+#define BUZZER_CHANNEL 6U       /**FTM3_CH6 is ALT3 of PTC10*/
+#define BUZZER_PRESCALE 2U      /**bus clock / 4*/
+#define STEP_CHANNEL kPIT_Chnl_3
+
+static uint32_t ftm_hz;     /**FTM3 counts per second*/
+static uint32_t pit_per_ms; /**PIT counts per millisecond*/
+
+void alarm_out_port_init(void)
+{
+    gpio_pin_config_t led = { kGPIO_DigitalOutput, LOGIC_LED_OFF };
+    pit_config_t config;
+
+    CLOCK_EnableClock(kCLOCK_PortB);
+    CLOCK_EnableClock(kCLOCK_PortC);
+    PORT_SetPinMux(PORTB, BOARD_LED_RED_GPIO_PIN, kPORT_MuxAsGpio);
+    GPIO_PinInit(BOARD_LED_RED_GPIO, BOARD_LED_RED_GPIO_PIN, &led);
+    PORT_SetPinMux(BUZZER_PORT, BUZZER_PIN, kPORT_MuxAlt3);
+
+    CLOCK_EnableClock(kCLOCK_Ftm3);
+    ftm_hz = CLOCK_GetFreq(kCLOCK_BusClk) >> BUZZER_PRESCALE;
+    /**FTMEN clear: a new MOD takes effect at the end of the current period*/
+    FTM3->MODE = FTM_MODE_WPDIS_MASK;
+    FTM3->SC = 0;
+    FTM3->CNTIN = 0;
+    FTM3->CNT = 0;
+    FTM3->MOD = 0xFFFFU;
+    FTM3->CONTROLS[BUZZER_CHANNEL].CnSC = FTM_CnSC_MSB_MASK | FTM_CnSC_ELSB_MASK;
+    FTM3->CONTROLS[BUZZER_CHANNEL].CnV = 0;
+    FTM3->SC = FTM_SC_CLKS(1U) | FTM_SC_PS(BUZZER_PRESCALE);
+
+    /**the PIT module may already run for the statistics and the trace*/
+    PIT_GetDefaultConfig(&config);
+    PIT_Init(PIT, &config);
+    pit_per_ms = CLOCK_GetFreq(kCLOCK_BusClk) / 1000U;
+    PIT_EnableInterrupts(PIT, STEP_CHANNEL, kPIT_TimerInterruptEnable);
+    /**the handler calls the player, which uses the FreeRTOS FromISR API*/
+    NVIC_SetPriority(PIT3_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY);
+    EnableIRQ(PIT3_IRQn);
+}
+
+void alarm_out_port_tone(uint16_t hz)
+{
+    uint32_t period;
+
+    if (0U == hz)
+    {
+        FTM3->CONTROLS[BUZZER_CHANNEL].CnV = 0;
+        return;
+    }
+    period = ftm_hz / hz;
+    if (period > 0x10000U)
+    {
+        period = 0x10000U;  /**lowest tone the prescaler reaches*/
+    }
+    FTM3->MOD = period - 1U;
+    FTM3->CONTROLS[BUZZER_CHANNEL].CnV = period / 2U;
+}
+
+void alarm_out_port_led(bool on)
+{
+    GPIO_PinWrite(BOARD_LED_RED_GPIO, BOARD_LED_RED_GPIO_PIN,
+                  on ? LOGIC_LED_ON : LOGIC_LED_OFF);
+}
+
+void alarm_out_port_timer(uint32_t ms)
+{
+    /**a PIT channel reloads on its own, it is stopped to run one period*/
+    PIT_StopTimer(PIT, STEP_CHANNEL);
+    PIT_ClearStatusFlags(PIT, STEP_CHANNEL, kPIT_TimerFlag);
+    if (ms)
+    {
+        PIT_SetTimerPeriod(PIT, STEP_CHANNEL, ms * pit_per_ms - 1U);
+        PIT_StartTimer(PIT, STEP_CHANNEL);
+    }
+}
+
+void PIT3_IRQHandler(void)
+{
+    PIT_StopTimer(PIT, STEP_CHANNEL);
+    PIT_ClearStatusFlags(PIT, STEP_CHANNEL, kPIT_TimerFlag);
+    alarm_out_step_from_isr();  /**starts the next period, if any*/
+    __DSB();
+}
+
+#endif /* APP_ALARM_OUT */
@@ -0,0 +1,318 @@
+/**
+ * @file    alarm_table.c
+ * @brief   Runtime alarm table kept as a min-heap of next firing times.
+ */
+
+#include "alarm_table.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "clock.h"
+#include "calendar.h"
+
+#define NOT_IN_HEAP (-1)        /**heap position of a disabled or free slot*/
+#define NEVER UINT32_MAX        /**next_fire of a dated alarm already past*/
+
+typedef struct {
+    alarm_t alarm;
+    uint32_t next_fire;         /**next clock second the alarm rings, heap key*/
+    int16_t heap_pos;           /**index in heap, NOT_IN_HEAP when not scheduled*/
+    bool used;
+} alarm_slot_t;
+
+static alarm_slot_t slots[ALARM_TABLE_SIZE];
+static alarm_id_t heap[ALARM_TABLE_SIZE];   /**slot ids ordered by next_fire*/
+static uint16_t heap_count;
+static uint32_t last_polled;    /**last clock second given to alarm_table_poll*/
+
+static void heap_place(uint16_t pos, alarm_id_t id)
+{
+    heap[pos] = id;
+    slots[id].heap_pos = pos;
+}
+
+static void sift_up(uint16_t pos)
+{
+    alarm_id_t id = heap[pos];
+
+    while (pos > 0)
+    {
+        uint16_t parent = (pos - 1) / 2;
+
+        if (slots[heap[parent]].next_fire <= slots[id].next_fire)
+        {
+            break;
+        }
+        heap_place(pos, heap[parent]);
+        pos = parent;
+    }
+    heap_place(pos, id);
+}
+
+static void sift_down(uint16_t pos)
+{
+    alarm_id_t id = heap[pos];
+
+    for (;;)
+    {
+        uint16_t child = 2 * pos + 1;
+
+        if (child >= heap_count)
+        {
+            break;
+        }
+        if ((child + 1 < heap_count)
+                && (slots[heap[child + 1]].next_fire
+                        < slots[heap[child]].next_fire))
+        {
+            child++;
+        }
+        if (slots[id].next_fire <= slots[heap[child]].next_fire)
+        {
+            break;
+        }
+        heap_place(pos, heap[child]);
+        pos = child;
+    }
+    heap_place(pos, id);
+}
+
+static void heap_insert(alarm_id_t id)
+{
+    heap_place(heap_count, id);
+    heap_count++;
+    sift_up(heap_count - 1);
+}
+
+static void heap_delete(alarm_id_t id)
+{
+    uint16_t pos = slots[id].heap_pos;
+
+    heap_count--;
+    slots[id].heap_pos = NOT_IN_HEAP;
+    if (pos == heap_count)
+    {
+        return;
+    }
+    heap_place(pos, heap[heap_count]);
+    sift_up(pos);
+    sift_down(slots[heap[pos]].heap_pos);
+}
+
+/**first clock second after the given one the alarm rings at, or NEVER*/
+static uint32_t next_occurrence(const alarm_t *alarm, uint32_t after)
+{
+    uint32_t day = after / SECONDS_PER_DAY;
+    uint32_t weekday;
+    uint32_t rotated;
+    uint32_t once;
+
+    if (ALARM_REPEATING != alarm->date)
+    {
+        once = alarm->date * SECONDS_PER_DAY + alarm->seconds_of_day;
+        return (once > after) ? once : NEVER;
+    }
+    if (day * SECONDS_PER_DAY + alarm->seconds_of_day <= after)
+    {
+        day++;
+    }
+    /**rotate the mask so bit 0 is the candidate day, the lowest set bit is the answer*/
+    weekday = calendar_weekday(day);
+    rotated = ((alarm->weekdays >> weekday) | (alarm->weekdays << (7U - weekday)))
+            & CALENDAR_EVERY_DAY;
+    return (day + (uint32_t)__builtin_ctz(rotated)) * SECONDS_PER_DAY
+            + alarm->seconds_of_day;
+}
+
+/**puts an enabled alarm in the heap at its first occurrence not polled yet*/
+static void schedule(alarm_id_t id)
+{
+    slots[id].next_fire = next_occurrence(&slots[id].alarm, last_polled);
+    if (NEVER != slots[id].next_fire)
+    {
+        heap_insert(id);
+    }
+}
+
+static void unschedule(alarm_id_t id)
+{
+    if (NOT_IN_HEAP != slots[id].heap_pos)
+    {
+        heap_delete(id);
+    }
+}
+
+static bool valid_id(alarm_id_t id)
+{
+    return (id >= 0) && (id < ALARM_TABLE_SIZE) && slots[id].used;
+}
+
+static bool valid_alarm(const alarm_t *alarm)
+{
+    if (alarm->seconds_of_day >= SECONDS_PER_DAY)
+    {
+        return false;
+    }
+    if (ALARM_REPEATING == alarm->date)
+    {
+        return (0 != (alarm->weekdays & CALENDAR_EVERY_DAY))
+                && (0 == (alarm->weekdays & ~CALENDAR_EVERY_DAY));
+    }
+    return alarm->date < UINT32_MAX / SECONDS_PER_DAY;
+}
+
+void alarm_table_init(uint32_t now)
+{
+    alarm_id_t id;
+
+    taskENTER_CRITICAL();
+    for (id = 0; id < ALARM_TABLE_SIZE; id++)
+    {
+        slots[id].used = false;
+        slots[id].alarm.enabled = false;
+        slots[id].heap_pos = NOT_IN_HEAP;
+    }
+    heap_count = 0;
+    last_polled = now - 1;
+    taskEXIT_CRITICAL();
+}
+
+alarm_id_t alarm_table_add(const alarm_t *alarm)
+{
+    alarm_id_t id;
+
+    if (!valid_alarm(alarm))
+    {
+        return ALARM_NONE;
+    }
+    taskENTER_CRITICAL();
+    for (id = 0; id < ALARM_TABLE_SIZE; id++)
+    {
+        if (!slots[id].used)
+        {
+            break;
+        }
+    }
+    if (ALARM_TABLE_SIZE == id)
+    {
+        taskEXIT_CRITICAL();
+        return ALARM_NONE;
+    }
+    slots[id].used = true;
+    slots[id].alarm = *alarm;
+    slots[id].heap_pos = NOT_IN_HEAP;
+    if (alarm->enabled)
+    {
+        schedule(id);
+    }
+    taskEXIT_CRITICAL();
+    return id;
+}
+
+bool alarm_table_remove(alarm_id_t id)
+{
+    taskENTER_CRITICAL();
+    if (!valid_id(id))
+    {
+        taskEXIT_CRITICAL();
+        return false;
+    }
+    unschedule(id);
+    slots[id].used = false;
+    slots[id].alarm.enabled = false;
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+bool alarm_table_enable(alarm_id_t id, bool enable)
+{
+    taskENTER_CRITICAL();
+    if (!valid_id(id))
+    {
+        taskEXIT_CRITICAL();
+        return false;
+    }
+    if (enable && !slots[id].alarm.enabled)
+    {
+        schedule(id);
+    } else if (!enable && slots[id].alarm.enabled)
+    {
+        unschedule(id);
+    }
+    slots[id].alarm.enabled = enable;
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+bool alarm_table_get(alarm_id_t id, alarm_t *alarm)
+{
+    taskENTER_CRITICAL();
+    if (!valid_id(id))
+    {
+        taskEXIT_CRITICAL();
+        return false;
+    }
+    *alarm = slots[id].alarm;
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+void alarm_table_rebase(uint32_t now)
+{
+    alarm_id_t id;
+    uint16_t pos;
+
+    taskENTER_CRITICAL();
+    last_polled = now - 1;
+    heap_count = 0;
+    for (id = 0; id < ALARM_TABLE_SIZE; id++)
+    {
+        slots[id].heap_pos = NOT_IN_HEAP;
+        if (slots[id].used && slots[id].alarm.enabled)
+        {
+            slots[id].next_fire = next_occurrence(&slots[id].alarm, last_polled);
+            if (NEVER != slots[id].next_fire)
+            {
+                heap_place(heap_count, id);
+                heap_count++;
+            }
+        }
+    }
+    /**bottom up heap construction, O(n)*/
+    for (pos = heap_count / 2; pos > 0; pos--)
+    {
+        sift_down(pos - 1);
+    }
+    taskEXIT_CRITICAL();
+}
+
+alarm_id_t alarm_table_poll(uint32_t now)
+{
+    alarm_id_t id;
+    alarm_slot_t *slot;
+
+    taskENTER_CRITICAL();
+    last_polled = now;
+    /**the only per-second work: one comparison against the next due alarm*/
+    if ((0 == heap_count) || (slots[heap[0]].next_fire > now))
+    {
+        taskEXIT_CRITICAL();
+        return ALARM_NONE;
+    }
+    id = heap[0];
+    slot = &slots[id];
+    /**reschedule on the first matching day after now, skipping any missed days*/
+    slot->next_fire = next_occurrence(&slot->alarm, now);
+    if (NEVER == slot->next_fire)
+    {
+        /**a dated alarm rings once*/
+        heap_delete(id);
+        slot->alarm.enabled = false;
+    } else
+    {
+        sift_down(0);
+    }
+    taskEXIT_CRITICAL();
+    return id;
+}
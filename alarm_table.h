@@ -0,0 +1,61 @@
+/**
+ * @file    alarm_table.h
+ * @brief   Runtime alarm table.
+ *
+ * Every enabled alarm sits in a binary min-heap keyed by its next firing
+ * time, in seconds of the clock counter. The per-second check is a single
+ * comparison against the heap root; adding, removing and enabling alarms
+ * are O(log n). An alarm either repeats on the days of a weekday mask or
+ * rings once on a date; the next matching day is found with a rotate and
+ * a count of trailing zeros of the mask, never by stepping through days.
+ */
+
+#ifndef ALARM_TABLE_H_
+#define ALARM_TABLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ALARM_TABLE_SIZE 128    /**maximum amount of alarms*/
+#define ALARM_NONE (-1)         /**returned when no alarm is due or the table is full*/
+#define ALARM_REPEATING UINT32_MAX  /**date of an alarm that repeats on weekdays*/
+
+typedef int16_t alarm_id_t;
+
+/**type definition for one alarm*/
+typedef struct {
+    uint32_t seconds_of_day;    /**time of the day it rings*/
+    uint32_t date;              /**day number it rings once, or ALARM_REPEATING*/
+    uint8_t weekdays;           /**weekday mask of a repeating alarm, bit 0 is Sunday*/
+    bool enabled;               /**a dated alarm disables itself once it rang*/
+} alarm_t;
+
+/**empties the table; now is the clock second that has not been polled yet*/
+void alarm_table_init(uint32_t now);
+
+/**adds an alarm, returns its id or ALARM_NONE if it is invalid or the table is full*/
+alarm_id_t alarm_table_add(const alarm_t *alarm);
+
+/**removes an alarm, returns false if the id is not in use*/
+bool alarm_table_remove(alarm_id_t id);
+
+/**enables or disables an alarm, returns false if the id is not in use*/
+bool alarm_table_enable(alarm_id_t id, bool enable);
+
+/**reads back an alarm, returns false if the id is not in use*/
+bool alarm_table_get(alarm_id_t id, alarm_t *alarm);
+
+/**
+ * Reschedules every enabled alarm after a clock jump; now is the clock
+ * second that has not been polled yet, as for alarm_table_init.
+ */
+void alarm_table_rebase(uint32_t now);
+
+/**
+ * Called once per clock second. Returns the id of an alarm due at or before
+ * now and schedules it for its next matching day, or ALARM_NONE. Call it again until
+ * it returns ALARM_NONE when several alarms share a second.
+ */
+alarm_id_t alarm_table_poll(uint32_t now);
+
+#endif /* ALARM_TABLE_H_ */
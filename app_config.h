@@ -0,0 +1,87 @@
+/**
+ * @file    app_config.h
+ * @brief   Application set up shared by the firmware and the host harness.
+ *
+ * Every value can be overridden from the compiler command line.
+ */
+
+#ifndef APP_CONFIG_H_
+#define APP_CONFIG_H_
+
+#ifndef HOURS_ALARM
+#define HOURS_ALARM 22  /**default alarm hour setup*/
+#endif
+#ifndef MINUTES_ALARM
+#define MINUTES_ALARM 1 /**default alarm minutes setup*/
+#endif
+#ifndef SECONDS_ALARM
+#define SECONDS_ALARM 2 /**default alarm seconds setup*/
+#endif
+
+#ifndef YEAR_INIT
+#define YEAR_INIT 2018  /**initial calendar date*/
+#endif
+#ifndef MONTH_INIT
+#define MONTH_INIT 1
+#endif
+#ifndef DAY_INIT
+#define DAY_INIT 1
+#endif
+
+#ifndef HOURS_INIT
+#define HOURS_INIT 22   /**initial clock hours*/
+#endif
+#ifndef MINUTES_INIT
+#define MINUTES_INIT 1  /**initial clock minutes*/
+#endif
+#ifndef SECONDS_INIT
+#define SECONDS_INIT 58 /**initial clock seconds*/
+#endif
+
+/**task priorities, the alarm preempts everything else*/
+#define ALARM_TASK_PRIORITY (configMAX_PRIORITIES - 1)
+#define CLOCK_TASK_PRIORITY (configMAX_PRIORITIES - 2)
+#define PRINT_TASK_PRIORITY (configMAX_PRIORITIES - 3)
+#define COUNTDOWN_TASK_PRIORITY PRINT_TASK_PRIORITY
+
+/**
+ * Stack words of each task: the deepest call chain's frames, room for the
+ * C library's printf and the context save. The "stack free" column of the
+ * stats command (APP_STATS=1) shows what is left on the board.
+ */
+#define ALARM_TASK_STACK (configMINIMAL_STACK_SIZE + 130)
+#define CLOCK_TASK_STACK (configMINIMAL_STACK_SIZE + 90)
+#define PRINT_TASK_STACK (configMINIMAL_STACK_SIZE + 200)
+#define CONSOLE_TASK_STACK (configMINIMAL_STACK_SIZE + 160) /**crash report printf*/
+#define PERSIST_TASK_STACK (configMINIMAL_STACK_SIZE + 90)
+#define COMMAND_TASK_STACK (configMINIMAL_STACK_SIZE + 230)
+#define COUNTDOWN_TASK_STACK (configMINIMAL_STACK_SIZE + 130)
+
+#define DATE_ROW 2      /**screen position of the date*/
+#define DATE_COL 10
+#define TIME_ROW 3      /**screen position of the time*/
+#define TIME_COL 10
+#define ALARM_ROW 5     /**screen position of the alarm message*/
+#define ALARM_COL 10
+#define ZONE_ROW 7      /**first row of the time zone views, one row each*/
+#define ZONE_COL 2
+#define CRASH_ROW 14    /**boot time crash report, below the renderer rows*/
+#define TEXT_ROW 20     /**command output, it scrolls from here to the bottom*/
+
+/**
+ * Time zone views, X(name, standard offset from the clock in minutes,
+ * daylight saving rule or NULL), 32 zones at most. print_task shows the
+ * zones of APP_ZONES_SHOWN until the 'zones' command changes them.
+ */
+#ifndef APP_TIMEZONES
+#define APP_TIMEZONES(X) \
+    X("UTC", 0, NULL) \
+    X("NYC", -5 * 60, &timezone_dst_us) \
+    X("MAD", 1 * 60, &timezone_dst_eu) \
+    X("GDL", -6 * 60, NULL)
+#endif
+#ifndef APP_ZONES_SHOWN
+#define APP_ZONES_SHOWN 0x0EU   /**every zone but the first, the clock itself*/
+#endif
+
+#endif /* APP_CONFIG_H_ */
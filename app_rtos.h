@@ -0,0 +1,82 @@
+/**
+ * @file    app_rtos.h
+ * @brief   Kernel object creation for both allocation modes.
+ *
+ * With APP_STATIC_ALLOCATION=1 every task and semaphore gets its storage
+ * from a static object placed by the linker, so start up never touches the
+ * kernel heap. Each macro expansion owns its own storage. In
+ * both modes a failed creation stops at configASSERT instead of leaving a
+ * NULL handle behind. Each task is given its own stack depth in words.
+ */
+
+#ifndef APP_RTOS_H_
+#define APP_RTOS_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/**heap bytes of a dynamically created task: stack, TCB and two heap_4 headers*/
+#define APP_TASK_HEAP(stack) ((stack) * sizeof(StackType_t) + sizeof(StaticTask_t) \
+        + 4U * portBYTE_ALIGNMENT)
+/**heap bytes of a dynamically created mutex or semaphore*/
+#define APP_SEMAPHORE_HEAP (sizeof(StaticQueue_t) + 2U * portBYTE_ALIGNMENT)
+
+#if APP_STATIC_ALLOCATION
+
+#define APP_TASK_CREATE(function, name, stack, priority, handle) \
+    do { \
+        static StackType_t task_stack[(stack)]; \
+        static StaticTask_t task_buffer; \
+        TaskHandle_t created = xTaskCreateStatic((function), (name), \
+                (stack), NULL, (priority), task_stack, &task_buffer); \
+        configASSERT(NULL != created); \
+        if (NULL != (handle)) \
+        { \
+            *(TaskHandle_t *)(handle) = created; \
+        } \
+    } while (0)
+
+#define APP_MUTEX_CREATE(mutex) \
+    do { \
+        static StaticSemaphore_t mutex_buffer; \
+        (mutex) = xSemaphoreCreateMutexStatic(&mutex_buffer); \
+        configASSERT(NULL != (mutex)); \
+    } while (0)
+
+#define APP_BINARY_SEMAPHORE_CREATE(semaphore) \
+    do { \
+        static StaticSemaphore_t semaphore_buffer; \
+        (semaphore) = xSemaphoreCreateBinaryStatic(&semaphore_buffer); \
+        configASSERT(NULL != (semaphore)); \
+    } while (0)
+
+#else
+
+#define APP_TASK_CREATE(function, name, stack, priority, handle) \
+    do { \
+        TaskHandle_t created = NULL; \
+        BaseType_t result = xTaskCreate((function), (name), (stack), \
+                                        NULL, (priority), &created); \
+        configASSERT(pdPASS == result); \
+        if (NULL != (handle)) \
+        { \
+            *(TaskHandle_t *)(handle) = created; \
+        } \
+    } while (0)
+
+#define APP_MUTEX_CREATE(mutex) \
+    do { \
+        (mutex) = xSemaphoreCreateMutex(); \
+        configASSERT(NULL != (mutex)); \
+    } while (0)
+
+#define APP_BINARY_SEMAPHORE_CREATE(semaphore) \
+    do { \
+        (semaphore) = xSemaphoreCreateBinary(); \
+        configASSERT(NULL != (semaphore)); \
+    } while (0)
+
+#endif /* APP_STATIC_ALLOCATION */
+
+#endif /* APP_RTOS_H_ */
@@ -0,0 +1,40 @@
+/**
+ * @file    binlog.c
+ * @brief   Binary log frame encoder.
+ *
+ * Encoding is a handful of byte stores, no formatting and no division, so
+ * a frame costs the same whatever the message.
+ */
+
+#include "binlog.h"
+
+#define BINLOG_COUNT(id, args, format) args,
+const uint8_t binlog_arg_count[BINLOG_MESSAGE_COUNT] = {
+    BINLOG_MESSAGES(BINLOG_COUNT)
+};
+#undef BINLOG_COUNT
+
+static uint8_t *put_bytes(uint8_t *out, uint32_t value, uint8_t bytes)
+{
+    while (bytes--)
+    {
+        *out++ = (uint8_t)value;
+        value >>= 8;
+    }
+    return out;
+}
+
+size_t binlog_encode(uint8_t *out, binlog_id_t id, uint32_t ticks,
+                     const uint32_t *args)
+{
+    uint8_t *end = out;
+    uint8_t i;
+
+    *end++ = (uint8_t)(BINLOG_SYNC | (id & BINLOG_ID_MASK));
+    end = put_bytes(end, ticks, 2);
+    for (i = 0; i < binlog_arg_count[id]; i++)
+    {
+        end = put_bytes(end, args[i], 4);
+    }
+    return (size_t)(end - out);
+}
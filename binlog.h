@@ -0,0 +1,59 @@
+/**
+ * @file    binlog.h
+ * @brief   Deferred formatting binary log (APP_BINLOG=1).
+ *
+ * Instead of formatting and rendering text, the tasks queue a short frame
+ * on the console: the message ID, the low 16 bits of the tick count and
+ * the raw 32 bit arguments, little endian. The format strings never leave
+ * this table; host/binlog_decode is built from the same header and turns
+ * the UART stream back into text. Bytes outside a frame are passed through,
+ * so the command replies stay readable.
+ *
+ *   byte 0     BINLOG_SYNC | message ID
+ *   byte 1-2   tick count, the decoder extends it across wrap arounds
+ *   byte 3...  BINLOG_MESSAGES argument count times 4 bytes
+ *
+ * Besides the usual printf conversions of unsigned values (%u, %x, %02u),
+ * a format may use %C: a clock second shown as weekday, date and time.
+ */
+
+#ifndef BINLOG_H_
+#define BINLOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef APP_BINLOG
+#define APP_BINLOG 0
+#endif
+
+#define BINLOG_SYNC 0xA0U       /**high nibble of the first byte, never ASCII*/
+#define BINLOG_ID_MASK 0x0FU
+#define BINLOG_ARGS_MAX 2
+#define BINLOG_FRAME_MAX (3 + 4 * BINLOG_ARGS_MAX)
+
+/**X(ID, argument count, format), at most 16 messages*/
+#define BINLOG_MESSAGES(X) \
+    X(BINLOG_START, 1, "log start, tick %u Hz") \
+    X(BINLOG_TIME,  1, "%C") \
+    X(BINLOG_ALARM, 1, "ALARM! %C")
+
+#define BINLOG_ENUM(id, args, format) id,
+/**message IDs*/
+typedef enum {
+    BINLOG_MESSAGES(BINLOG_ENUM)
+    BINLOG_MESSAGE_COUNT
+} binlog_id_t;
+#undef BINLOG_ENUM
+
+/**argument count of each message*/
+extern const uint8_t binlog_arg_count[BINLOG_MESSAGE_COUNT];
+
+/**
+ * Encodes one frame into out, which holds BINLOG_FRAME_MAX bytes, and
+ * returns its length. args holds binlog_arg_count[id] values.
+ */
+size_t binlog_encode(uint8_t *out, binlog_id_t id, uint32_t ticks,
+                     const uint32_t *args);
+
+#endif /* BINLOG_H_ */
@@ -0,0 +1,61 @@
+/**
+ * @file    boot_time.c
+ * @brief   Boot timeline marks and report.
+ *
+ * The report is one line, the time of each step from reset and the time
+ * spent since the previous one:
+ *   boot main 1800 +1800 clocks 2400 +600 ... us
+ */
+
+#include "boot_time.h"
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "console.h"
+
+#define BOOT_LINE 48    /**longest line of the report*/
+
+static const char *const mark_names[BOOT_MARK_COUNT] = {
+    "main", "clocks", "restored", "scheduler", "first-second"
+};
+
+static uint32_t marks[BOOT_MARK_COUNT];
+static uint8_t marked;  /**bit per step already recorded*/
+
+void boot_mark(boot_mark_t mark)
+{
+    uint32_t us;
+
+    if (marked & (1U << mark))
+    {
+        return;
+    }
+    us = boot_timer_port_read_us();
+    taskENTER_CRITICAL();
+    marks[mark] = us;
+    marked |= (uint8_t)(1U << mark);
+    taskEXIT_CRITICAL();
+}
+
+void boot_report(void)
+{
+    char line[BOOT_LINE];
+    uint32_t previous = 0;
+    uint8_t mark;
+
+    console_put_line("\r\nboot");
+    for (mark = 0; mark < BOOT_MARK_COUNT; mark++)
+    {
+        if (marked & (1U << mark))
+        {
+            snprintf(line, sizeof(line), " %s %lu +%lu", mark_names[mark],
+                     (unsigned long)marks[mark],
+                     (unsigned long)(marks[mark] - previous));
+            console_put_line(line);
+            previous = marks[mark];
+        }
+    }
+    console_put_line(" us\r\n");
+}
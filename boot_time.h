@@ -0,0 +1,34 @@
+/**
+ * @file    boot_time.h
+ * @brief   Boot timeline, from reset to the first displayed second.
+ *
+ * Each step of the start up records the microseconds since reset once;
+ * the 'boot' command prints the timeline so boot time can be tracked.
+ */
+
+#ifndef BOOT_TIME_H_
+#define BOOT_TIME_H_
+
+#include <stdint.h>
+
+/**steps of the start up, in order*/
+typedef enum {
+    BOOT_MAIN,          /**main entered, after the C runtime start up*/
+    BOOT_CLOCKS,        /**core and bus clocks running at full speed*/
+    BOOT_RESTORED,      /**time base and alarms restored*/
+    BOOT_SCHEDULER,     /**kernel objects and tasks ready, scheduler starting*/
+    BOOT_FIRST_SECOND,  /**first time update queued for the display*/
+    BOOT_MARK_COUNT
+} boot_mark_t;
+
+/**records a step, only its first time counts*/
+void boot_mark(boot_mark_t mark);
+
+/**writes the timeline to the console*/
+void boot_report(void);
+
+/**microseconds since reset, provided by the board layer; it is read at
+ * least every few seconds during the start up and need not run after it*/
+uint32_t boot_timer_port_read_us(void);
+
+#endif /* BOOT_TIME_H_ */
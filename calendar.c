@@ -0,0 +1,79 @@
+/**
+ * @file    calendar.c
+ * @brief   Constant time day number and date conversions.
+ *
+ * The year is counted from March so the leap day is the last day of the
+ * year; inside a 400 year era every quantity follows from divisions by
+ * fixed cycle lengths (1460, 36524 and 146096 days).
+ */
+
+#include "calendar.h"
+
+#define DAYS_PER_ERA 146097U        /**days in 400 Gregorian years*/
+#define EPOCH_SHIFT 730425U         /**days from 0000-03-01 to 2000-01-01*/
+
+static const uint8_t days_in_month[12] = {
+    31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+static const char *const weekday_names[7] = {
+    "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+};
+
+static bool leap_year(uint16_t year)
+{
+    return ((0 == year % 4U) && (0 != year % 100U)) || (0 == year % 400U);
+}
+
+bool calendar_valid(uint16_t year, uint8_t month, uint8_t day)
+{
+    uint8_t last;
+
+    if ((year < CALENDAR_EPOCH_YEAR) || (year > CALENDAR_LAST_YEAR)
+            || (month < 1) || (month > 12) || (day < 1))
+    {
+        return false;
+    }
+    last = days_in_month[month - 1];
+    if ((2 == month) && leap_year(year))
+    {
+        last++;
+    }
+    return day <= last;
+}
+
+uint32_t calendar_to_days(uint16_t year, uint8_t month, uint8_t day)
+{
+    uint32_t y = (uint32_t)year - (month <= 2 ? 1U : 0U);
+    uint32_t era = y / 400U;
+    uint32_t year_of_era = y - era * 400U;
+    uint32_t day_of_year = (153U * (month > 2 ? month - 3U : month + 9U) + 2U) / 5U
+            + day - 1U;
+    uint32_t day_of_era = year_of_era * 365U + year_of_era / 4U
+            - year_of_era / 100U + day_of_year;
+
+    return era * DAYS_PER_ERA + day_of_era - EPOCH_SHIFT;
+}
+
+void calendar_from_days(uint32_t days, calendar_date_t *date)
+{
+    uint32_t shifted = days + EPOCH_SHIFT;
+    uint32_t era = shifted / DAYS_PER_ERA;
+    uint32_t day_of_era = shifted - era * DAYS_PER_ERA;
+    uint32_t year_of_era = (day_of_era - day_of_era / 1460U
+            + day_of_era / 36524U - day_of_era / (DAYS_PER_ERA - 1U)) / 365U;
+    uint32_t day_of_year = day_of_era
+            - (365U * year_of_era + year_of_era / 4U - year_of_era / 100U);
+    uint32_t month_index = (5U * day_of_year + 2U) / 153U;  /**0 is March*/
+    uint32_t month = month_index < 10U ? month_index + 3U : month_index - 9U;
+
+    date->year = (uint16_t)(year_of_era + era * 400U + (month <= 2U ? 1U : 0U));
+    date->month = (uint8_t)month;
+    date->day = (uint8_t)(day_of_year - (153U * month_index + 2U) / 5U + 1U);
+    date->weekday = calendar_weekday(days);
+}
+
+const char *calendar_weekday_name(uint8_t weekday)
+{
+    return weekday_names[weekday % 7U];
+}
@@ -0,0 +1,60 @@
+/**
+ * @file    calendar.h
+ * @brief   Gregorian calendar on top of the clock seconds counter.
+ *
+ * Clock second 0 is 2000-01-01 00:00:00, so a day number is simply the
+ * clock second divided by SECONDS_PER_DAY. Converting between day numbers
+ * and dates is a fixed handful of integer operations (the days-from-civil
+ * algorithm on 400 year eras), with no loop over days, months or years.
+ * The 32 bit counter covers 2000 to 2135.
+ */
+
+#ifndef CALENDAR_H_
+#define CALENDAR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CALENDAR_EPOCH_YEAR 2000U   /**year of day 0*/
+#define CALENDAR_LAST_YEAR 2135U    /**last year the clock counter reaches*/
+
+/**day of the week, the bit of a weekday mask is 1 << weekday*/
+typedef enum {
+    CALENDAR_SUNDAY,
+    CALENDAR_MONDAY,
+    CALENDAR_TUESDAY,
+    CALENDAR_WEDNESDAY,
+    CALENDAR_THURSDAY,
+    CALENDAR_FRIDAY,
+    CALENDAR_SATURDAY
+} calendar_weekday_t;
+
+#define CALENDAR_EVERY_DAY 0x7FU    /**weekday mask with every day set*/
+
+/**type definition for a calendar date*/
+typedef struct {
+    uint16_t year;
+    uint8_t month;      /**1 to 12*/
+    uint8_t day;        /**1 to 31*/
+    uint8_t weekday;    /**calendar_weekday_t*/
+} calendar_date_t;
+
+/**weekday of a day number, day 0 was a Saturday*/
+static inline uint8_t calendar_weekday(uint32_t days)
+{
+    return (uint8_t)((days + CALENDAR_SATURDAY) % 7U);
+}
+
+/**checks a year, month and day triple*/
+bool calendar_valid(uint16_t year, uint8_t month, uint8_t day);
+
+/**day number of a valid date*/
+uint32_t calendar_to_days(uint16_t year, uint8_t month, uint8_t day);
+
+/**date of a day number*/
+void calendar_from_days(uint32_t days, calendar_date_t *date);
+
+/**three letter English name of a weekday*/
+const char *calendar_weekday_name(uint8_t weekday);
+
+#endif /* CALENDAR_H_ */
@@ -0,0 +1,122 @@
+/**
+ * @file    clock.c
+ * @brief   Tick clock source: seconds counter derived from the kernel tick count.
+ *
+ * The reference pair (base_seconds, base_tick) only changes when the tick
+ * difference gets close to wrapping. It is published under a sequence
+ * counter: the writer updates it inside a critical section, so a reader
+ * never spins, and the retry loop only guards against a torn read.
+ */
+
+#include "clock.h"
+
+#include "task.h"
+
+#if !APP_CLOCK_RTC
+
+/**rebase once the tick difference passes half of the TickType_t range*/
+#define CLOCK_REBASE_TICKS ((TickType_t)1 << 31)
+
+static volatile uint32_t sequence;      /**odd while the reference is updated*/
+static volatile uint32_t base_seconds;  /**clock second at base_tick*/
+static volatile TickType_t base_tick;   /**tick at which base_seconds started*/
+
+static void read_base(uint32_t *seconds, TickType_t *tick)
+{
+    uint32_t start;
+
+    do
+    {
+        start = sequence;
+        __sync_synchronize();
+        *seconds = base_seconds;
+        *tick = base_tick;
+        __sync_synchronize();
+    } while ((start & 1U) || (start != sequence));
+}
+
+static void write_base(uint32_t seconds, TickType_t tick)
+{
+    taskENTER_CRITICAL();
+    sequence++;
+    __sync_synchronize();
+    base_seconds = seconds;
+    base_tick = tick;
+    __sync_synchronize();
+    sequence++;
+    taskEXIT_CRITICAL();
+}
+
+void clock_init(uint32_t seconds)
+{
+    write_base(seconds, xTaskGetTickCount());
+}
+
+uint32_t clock_now(void)
+{
+    uint32_t seconds;
+    TickType_t tick;
+
+    read_base(&seconds, &tick);
+    return seconds + (xTaskGetTickCount() - tick) / CLOCK_PERIOD_TICKS;
+}
+
+/**tick count at which the given clock second starts*/
+static TickType_t second_start_tick(uint32_t seconds)
+{
+    uint32_t base;
+    TickType_t tick;
+
+    read_base(&base, &tick);
+    return tick + (TickType_t)(seconds - base) * CLOCK_PERIOD_TICKS;
+}
+
+void clock_set(uint32_t seconds)
+{
+    uint32_t base;
+    TickType_t tick;
+    TickType_t elapsed;
+
+    read_base(&base, &tick);
+    elapsed = xTaskGetTickCount() - tick;
+    write_base(seconds, tick + (elapsed / CLOCK_PERIOD_TICKS) * CLOCK_PERIOD_TICKS);
+}
+
+/**
+ * Moves the tick reference forward so the tick difference never wraps;
+ * run by the clock owner once per second, far more often than the 2^31
+ * ticks it needs.
+ */
+static void maintain(void)
+{
+    uint32_t seconds;
+    TickType_t tick;
+    TickType_t elapsed;
+
+    read_base(&seconds, &tick);
+    elapsed = xTaskGetTickCount() - tick;
+    if (elapsed >= CLOCK_REBASE_TICKS)
+    {
+        /**whole seconds only, the sub-second phase is kept*/
+        seconds += elapsed / CLOCK_PERIOD_TICKS;
+        tick += (elapsed / CLOCK_PERIOD_TICKS) * CLOCK_PERIOD_TICKS;
+        write_base(seconds, tick);
+    }
+}
+
+uint32_t clock_wait_second(void)
+{
+    static TickType_t wake_tick;
+    static bool started = false;
+
+    if (!started)
+    {
+        wake_tick = second_start_tick(clock_now());
+        started = true;
+    }
+    vTaskDelayUntil(&wake_tick, CLOCK_PERIOD_TICKS);
+    maintain();
+    return clock_now();
+}
+
+#endif /* !APP_CLOCK_RTC */
@@ -0,0 +1,100 @@
+/**
+ * @file    clock.h
+ * @brief   Single time base of the application.
+ *
+ * The time is one monotonic seconds counter, so there is no per-unit state
+ * to keep in step. Hours, minutes and seconds are computed by the readers
+ * on demand. Reads are O(1) and never take a lock or wake a task.
+ *
+ * The counter comes from one of two clock sources with the same interface:
+ *
+ *   APP_CLOCK_RTC=0   clock.c, derived from the kernel tick count
+ *   APP_CLOCK_RTC=1   clock_rtc.c, the hardware RTC seconds counter; its
+ *                     seconds interrupt wakes the clock owner, the kernel
+ *                     tick takes no part in timekeeping
+ */
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/**selects the RTC clock source*/
+#ifndef APP_CLOCK_RTC
+#define APP_CLOCK_RTC 0
+#endif
+
+#define TOP_SECONDS 60  /**the amount of seconds in 1 minute*/
+#define TOP_MINUTES 60  /**the amount of minutes in 1 hour*/
+#define TOP_HOURS 24    /**the amount of hours in 1 day*/
+
+/**the amount of seconds in 1 day*/
+#define SECONDS_PER_DAY ((uint32_t)TOP_HOURS * TOP_MINUTES * TOP_SECONDS)
+/**converts an h:m:s triple into seconds of the day*/
+#define HMS_TO_SECONDS(h, m, s) \
+    ((((uint32_t)(h) * TOP_MINUTES) + (m)) * TOP_SECONDS + (s))
+
+/**simulated seconds per real second, only raised by the host build*/
+#ifndef CLOCK_TIME_SCALE
+#define CLOCK_TIME_SCALE 1
+#endif
+/**ticks per clock second, never less than one tick*/
+#define CLOCK_PERIOD_TICKS \
+    ((pdMS_TO_TICKS(1000) / CLOCK_TIME_SCALE) ? \
+     (pdMS_TO_TICKS(1000) / CLOCK_TIME_SCALE) : 1)
+
+/**time of the day split in its units*/
+typedef struct {
+    uint8_t hours;
+    uint8_t minutes;
+    uint8_t seconds;
+} clock_hms_t;
+
+/**
+ * Starts the time base at the given clock second. An RTC that kept running
+ * through the reset keeps its own, more accurate, time instead.
+ */
+void clock_init(uint32_t seconds);
+
+/**clock seconds elapsed since 00:00:00 of the first day*/
+uint32_t clock_now(void);
+
+/**
+ * Makes the current clock second read as seconds. The clock never stops
+ * and its owner keeps waking once per second.
+ */
+void clock_set(uint32_t seconds);
+
+/**
+ * Blocks the calling task, the single clock owner, until the next clock
+ * second starts and returns it.
+ */
+uint32_t clock_wait_second(void);
+
+#if APP_CLOCK_RTC
+/**
+ * RTC seconds counter, provided by the board layer. Init returns true if
+ * the counter kept valid time through the reset.
+ */
+bool clock_rtc_port_init(void);
+uint32_t clock_rtc_port_read(void);
+void clock_rtc_port_write(uint32_t seconds);
+
+/**called by the board layer from the RTC seconds interrupt, FromISR convention*/
+void clock_rtc_second_from_isr(BaseType_t *higher_priority_woken);
+#endif
+
+/**splits a clock second into hours, minutes and seconds of its day*/
+static inline void clock_to_hms(uint32_t seconds, clock_hms_t *hms)
+{
+    uint32_t seconds_of_day = seconds % SECONDS_PER_DAY;
+
+    hms->hours = seconds_of_day / (TOP_MINUTES * TOP_SECONDS);
+    hms->minutes = (seconds_of_day / TOP_SECONDS) % TOP_MINUTES;
+    hms->seconds = seconds_of_day % TOP_SECONDS;
+}
+
+#endif /* CLOCK_H_ */
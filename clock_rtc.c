@@ -0,0 +1,53 @@
+/**
+ * @file    clock_rtc.c
+ * @brief   RTC clock source: seconds counter kept by the hardware RTC.
+ *
+ * The clock second is the RTC seconds register itself, so it keeps
+ * counting through resets on the backup supply and is untouched by tick
+ * jitter or by the tick rate. The RTC seconds interrupt only gives a task
+ * notification to the clock owner; all the work is deferred to that task.
+ */
+
+#include "clock.h"
+
+#include "task.h"
+
+#if APP_CLOCK_RTC
+
+static TaskHandle_t volatile owner;    /**task blocked in clock_wait_second*/
+
+void clock_init(uint32_t seconds)
+{
+    if (!clock_rtc_port_init())
+    {
+        clock_rtc_port_write(seconds);
+    }
+}
+
+uint32_t clock_now(void)
+{
+    return clock_rtc_port_read();
+}
+
+void clock_set(uint32_t seconds)
+{
+    clock_rtc_port_write(seconds);
+}
+
+uint32_t clock_wait_second(void)
+{
+    owner = xTaskGetCurrentTaskHandle();
+    /**several pending seconds collapse into one wake up, the poll catches up*/
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return clock_now();
+}
+
+void clock_rtc_second_from_isr(BaseType_t *higher_priority_woken)
+{
+    if (NULL != owner)
+    {
+        vTaskNotifyGiveFromISR(owner, higher_priority_woken);
+    }
+}
+
+#endif /* APP_CLOCK_RTC */
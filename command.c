@@ -0,0 +1,634 @@
+/**
+ * @file    command.c
+ * @brief   Console command parser and handlers.
+ */
+
+#include "command.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "clock.h"
+#include "calendar.h"
+#include "alarm_table.h"
+#include "console.h"
+#include "binlog.h"
+#include "vt100_render.h"
+#include "persist.h"
+#include "timezone.h"
+#include "hrtimer.h"
+#include "boot_time.h"
+#include "alarm_out.h"
+#include "stats.h"
+#include "trace.h"
+#include "low_power.h"
+
+#define COMMAND_REPLY 64    /**longest reply line*/
+
+/**type definition for one command handler, argv[0] is the command name*/
+typedef void (*command_handler_t)(int argc, char **argv);
+
+typedef struct {
+    const char *name;
+    int min_argc;           /**words expected, command name included*/
+    int max_argc;
+    command_handler_t handler;
+} command_t;
+
+/**parses a decimal field of one up to digits digits, below limit*/
+static bool parse_field(const char **text, int digits, uint32_t limit,
+                        uint32_t *value)
+{
+    const char *p = *text;
+    uint32_t v = 0;
+
+    while ((*p >= '0') && (*p <= '9') && (p - *text < digits))
+    {
+        v = v * 10 + (uint32_t)(*p - '0');
+        p++;
+    }
+    if ((p == *text) || (v >= limit))
+    {
+        return false;
+    }
+    *text = p;
+    *value = v;
+    return true;
+}
+
+/**parses HH:MM:SS into a second of the day*/
+static bool parse_hms(const char *text, uint32_t *seconds_of_day)
+{
+    uint32_t hours;
+    uint32_t minutes;
+    uint32_t seconds;
+
+    if (!parse_field(&text, 2, TOP_HOURS, &hours) || (':' != *text++)
+            || !parse_field(&text, 2, TOP_MINUTES, &minutes) || (':' != *text++)
+            || !parse_field(&text, 2, TOP_SECONDS, &seconds) || ('\0' != *text))
+    {
+        return false;
+    }
+    *seconds_of_day = HMS_TO_SECONDS(hours, minutes, seconds);
+    return true;
+}
+
+/**parses YYYY-MM-DD into a day number*/
+static bool parse_date(const char *text, uint32_t *days)
+{
+    uint32_t year;
+    uint32_t month;
+    uint32_t day;
+
+    if (!parse_field(&text, 4, 10000, &year) || ('-' != *text++)
+            || !parse_field(&text, 2, 13, &month) || ('-' != *text++)
+            || !parse_field(&text, 2, 32, &day) || ('\0' != *text)
+            || !calendar_valid((uint16_t)year, (uint8_t)month, (uint8_t)day))
+    {
+        return false;
+    }
+    *days = calendar_to_days((uint16_t)year, (uint8_t)month, (uint8_t)day);
+    return true;
+}
+
+/**parses daily, weekdays, weekends or a list such as mon,wed,fri*/
+static bool parse_weekdays(const char *text, uint8_t *weekdays)
+{
+    uint8_t mask = 0;
+    uint8_t weekday;
+
+    if (0 == strcmp(text, "daily"))
+    {
+        *weekdays = CALENDAR_EVERY_DAY;
+        return true;
+    }
+    if (0 == strcmp(text, "weekdays"))
+    {
+        *weekdays = CALENDAR_EVERY_DAY
+                & ~((1U << CALENDAR_SUNDAY) | (1U << CALENDAR_SATURDAY));
+        return true;
+    }
+    if (0 == strcmp(text, "weekends"))
+    {
+        *weekdays = (1U << CALENDAR_SUNDAY) | (1U << CALENDAR_SATURDAY);
+        return true;
+    }
+    for (;;)
+    {
+        for (weekday = 0; weekday < 7; weekday++)
+        {
+            if (0 == strncasecmp(text, calendar_weekday_name(weekday), 3))
+            {
+                break;
+            }
+        }
+        if (7 == weekday)
+        {
+            return false;
+        }
+        mask |= (uint8_t)(1U << weekday);
+        text += 3;
+        if ('\0' == *text)
+        {
+            break;
+        }
+        if (',' != *text++)
+        {
+            return false;
+        }
+    }
+    *weekdays = mask;
+    return true;
+}
+
+/**moves the clock to target without stopping it*/
+static void apply_time(uint32_t target)
+{
+    /*
+     * The clock reference and the alarm heap change together with the
+     * scheduler suspended, so clock_task never polls the alarms against a
+     * half applied time. Both updates are short critical sections and the
+     * clock source keeps counting, the clock does not stop.
+     */
+    vTaskSuspendAll();
+    clock_set(target);
+    alarm_table_rebase(target);
+    xTaskResumeAll();
+    persist_request();
+    console_put_line("\r\nok\r\n");
+}
+
+static void cmd_set_time(int argc, char **argv)
+{
+    uint32_t seconds_of_day;
+    uint32_t now;
+
+    if (!parse_hms(argv[1], &seconds_of_day))
+    {
+        console_put_line("\r\nusage: set-time HH:MM:SS\r\n");
+        return;
+    }
+    /**the date is kept*/
+    now = clock_now();
+    apply_time(now - (now % SECONDS_PER_DAY) + seconds_of_day);
+}
+
+static void cmd_set_date(int argc, char **argv)
+{
+    uint32_t days;
+
+    if (!parse_date(argv[1], &days))
+    {
+        console_put_line("\r\nusage: set-date YYYY-MM-DD\r\n");
+        return;
+    }
+    /**the time of the day is kept*/
+    apply_time(days * SECONDS_PER_DAY + clock_now() % SECONDS_PER_DAY);
+}
+
+static void cmd_set_alarm(int argc, char **argv)
+{
+    char line[COMMAND_REPLY];
+    alarm_t alarm;
+    alarm_id_t id;
+
+    alarm.date = ALARM_REPEATING;
+    alarm.weekdays = CALENDAR_EVERY_DAY;
+    alarm.enabled = true;
+    if (!parse_hms(argv[1], &alarm.seconds_of_day)
+            || ((argc > 2) && !parse_date(argv[2], &alarm.date)
+                    && !parse_weekdays(argv[2], &alarm.weekdays)))
+    {
+        console_put_line("\r\nusage: set-alarm HH:MM:SS [YYYY-MM-DD|daily|weekdays|"
+                 "weekends|mon,tue,...]\r\n");
+        return;
+    }
+    id = alarm_table_add(&alarm);
+    if (ALARM_NONE == id)
+    {
+        console_put_line("\r\nalarm table full\r\n");
+        return;
+    }
+    persist_request();
+    snprintf(line, sizeof(line), "\r\nalarm %d added\r\n", id);
+    console_put_line(line);
+}
+
+static void cmd_del_alarm(int argc, char **argv)
+{
+    const char *text = argv[1];
+    uint32_t id;
+
+    if (!parse_field(&text, 3, ALARM_TABLE_SIZE, &id) || ('\0' != *text)
+            || !alarm_table_remove((alarm_id_t)id))
+    {
+        console_put_line("\r\nno such alarm\r\n");
+        return;
+    }
+    persist_request();
+    console_put_line("\r\nok\r\n");
+}
+
+/**writes the date, or the weekdays, an alarm rings on*/
+static void format_days(char *out, size_t size, const alarm_t *alarm)
+{
+    calendar_date_t date;
+    uint8_t weekday;
+    size_t len = 0;
+
+    if (ALARM_REPEATING != alarm->date)
+    {
+        calendar_from_days(alarm->date, &date);
+        snprintf(out, size, "%04u-%02u-%02u", date.year, date.month, date.day);
+        return;
+    }
+    if (CALENDAR_EVERY_DAY == alarm->weekdays)
+    {
+        snprintf(out, size, "daily");
+        return;
+    }
+    out[0] = '\0';
+    for (weekday = 0; weekday < 7; weekday++)
+    {
+        if ((alarm->weekdays & (1U << weekday)) && (len + 5 <= size))
+        {
+            len += (size_t)snprintf(&out[len], size - len, len ? ",%s" : "%s",
+                                    calendar_weekday_name(weekday));
+        }
+    }
+}
+
+static void cmd_list(int argc, char **argv)
+{
+    char line[COMMAND_REPLY];
+    char days[32];
+    calendar_date_t date;
+    clock_hms_t time;
+    uint32_t now = clock_now();
+    alarm_t alarm;
+    alarm_id_t id;
+
+    calendar_from_days(now / SECONDS_PER_DAY, &date);
+    clock_to_hms(now, &time);
+    snprintf(line, sizeof(line), "\r\n%s %04u-%02u-%02u %02u:%02u:%02u\r\n",
+             calendar_weekday_name(date.weekday), date.year, date.month,
+             date.day, time.hours, time.minutes, time.seconds);
+    console_put_line(line);
+    for (id = 0; id < ALARM_TABLE_SIZE; id++)
+    {
+        if (alarm_table_get(id, &alarm))
+        {
+            clock_to_hms(alarm.seconds_of_day, &time);
+            format_days(days, sizeof(days), &alarm);
+            snprintf(line, sizeof(line), "alarm %3d %02u:%02u:%02u %s %s\r\n",
+                     id, time.hours, time.minutes, time.seconds, days,
+                     alarm.enabled ? "on" : "off");
+            console_put_line(line);
+        }
+    }
+}
+
+/**parses none, all or a comma separated list of zone names, in place*/
+static bool parse_zones(char *text, uint32_t *mask)
+{
+    char *next;
+    uint8_t zone;
+
+    *mask = 0;
+    if (0 == strcmp(text, "none"))
+    {
+        return true;
+    }
+    if (0 == strcmp(text, "all"))
+    {
+        *mask = (timezone_count() < 32) ? (1UL << timezone_count()) - 1U
+                : UINT32_MAX;
+        return true;
+    }
+    for (; text; text = next)
+    {
+        next = strchr(text, ',');
+        if (next)
+        {
+            *next++ = '\0';
+        }
+        zone = timezone_find(text);
+        if (TIMEZONE_NONE == zone)
+        {
+            return false;
+        }
+        *mask |= 1UL << zone;
+    }
+    return true;
+}
+
+static void cmd_zones(int argc, char **argv)
+{
+    char line[COMMAND_REPLY];
+    calendar_date_t date;
+    clock_hms_t time;
+    uint32_t now = clock_now();
+    uint32_t local;
+    uint32_t mask;
+    int32_t offset;
+    bool summer;
+    uint8_t zone;
+
+    if (argc > 1)
+    {
+        if (!parse_zones(argv[1], &mask))
+        {
+            console_put_line("\r\nusage: zones [none|all|NAME,NAME,...]\r\n");
+            return;
+        }
+        timezone_show(mask);
+        console_put_line("\r\nok\r\n");
+        return;
+    }
+    console_put_line("\r\n");
+    for (zone = 0; zone < timezone_count(); zone++)
+    {
+        local = timezone_local(zone, now, &summer);
+        offset = (int32_t)(local - now) / TOP_SECONDS;
+        calendar_from_days(local / SECONDS_PER_DAY, &date);
+        clock_to_hms(local, &time);
+        snprintf(line, sizeof(line),
+                 "zone %-4s %c%02ld:%02ld %04u-%02u-%02u %02u:%02u:%02u%s%s\r\n",
+                 timezone_name(zone), (offset < 0) ? '-' : '+',
+                 (long)(offset < 0 ? -offset : offset) / TOP_MINUTES,
+                 (long)(offset < 0 ? -offset : offset) % TOP_MINUTES,
+                 date.year, date.month, date.day, time.hours, time.minutes,
+                 time.seconds, summer ? " dst" : "",
+                 (timezone_shown() & (1UL << zone)) ? " shown" : "");
+        console_put_line(line);
+    }
+}
+
+#if APP_HRTIMER
+static void cmd_stopwatch(int argc, char **argv)
+{
+    static hrtimer_stopwatch_t stopwatch;
+    char line[COMMAND_REPLY];
+    uint64_t us;
+
+    if (argc > 1)
+    {
+        if (0 == strcmp(argv[1], "start"))
+        {
+            hrtimer_stopwatch_start(&stopwatch);
+        } else if (0 == strcmp(argv[1], "stop"))
+        {
+            hrtimer_stopwatch_stop(&stopwatch);
+        } else if (0 == strcmp(argv[1], "reset"))
+        {
+            hrtimer_stopwatch_reset(&stopwatch);
+        } else
+        {
+            console_put_line("\r\nusage: stopwatch [start|stop|reset]\r\n");
+            return;
+        }
+    }
+    /**every subcommand answers with the reading, a stop is a lap time too*/
+    us = hrtimer_stopwatch_us(&stopwatch);
+    snprintf(line, sizeof(line), "\r\nstopwatch %lu.%06lu s %s\r\n",
+             (unsigned long)(us / 1000000U), (unsigned long)(us % 1000000U),
+             stopwatch.running ? "running" : "stopped");
+    console_put_line(line);
+}
+
+static void cmd_countdown(int argc, char **argv)
+{
+    char line[COMMAND_REPLY];
+    const char *text = argv[argc - 1];
+    uint64_t us;
+    uint32_t value;
+    uint8_t id;
+
+    if (1 == argc)
+    {
+        console_put_line("\r\n");
+        for (id = 0; id < HRTIMER_COUNTDOWNS; id++)
+        {
+            if (hrtimer_countdown_left(id, &us))
+            {
+                snprintf(line, sizeof(line), "countdown %u %lu.%03lu ms left\r\n",
+                         id, (unsigned long)(us / 1000U), (unsigned long)(us % 1000U));
+                console_put_line(line);
+            }
+        }
+        return;
+    }
+    if (!parse_field(&text, 8, 100000000U, &value) || ('\0' != *text)
+            || ((3 == argc) && (0 != strcmp(argv[1], "cancel"))))
+    {
+        console_put_line("\r\nusage: countdown [MS|cancel ID]\r\n");
+        return;
+    }
+    if (3 == argc)
+    {
+        /**the id is checked before it is narrowed, 256 is not countdown 0*/
+        console_put_line(((value < HRTIMER_COUNTDOWNS)
+                          && hrtimer_countdown_cancel((uint8_t)value)) ? "\r\nok\r\n"
+                 : "\r\nno such countdown\r\n");
+        return;
+    }
+    id = hrtimer_countdown_start((uint64_t)value * 1000U);
+    if (HRTIMER_NONE == id)
+    {
+        console_put_line("\r\nall countdowns running\r\n");
+        return;
+    }
+    snprintf(line, sizeof(line), "\r\ncountdown %u started\r\n", id);
+    console_put_line(line);
+}
+#endif
+
+#if APP_ALARM_OUT
+static void cmd_snooze(int argc, char **argv)
+{
+    console_put_line(alarm_out_snooze() ? "\r\nsnoozed\r\n" : "\r\nnot ringing\r\n");
+}
+
+static void cmd_alarm_off(int argc, char **argv)
+{
+    alarm_out_stop();
+    console_put_line("\r\nok\r\n");
+}
+
+static void cmd_ring(int argc, char **argv)
+{
+    const char *text = argv[argc - 1];
+    uint32_t pattern = ALARM_OUT_PATTERN;
+
+    if ((2 == argc) && (!parse_field(&text, 1, ALARM_PATTERN_COUNT, &pattern)
+            || ('\0' != *text)))
+    {
+        console_put_line("\r\nusage: ring [PATTERN]\r\n");
+        return;
+    }
+    /**plays a pattern as an alarm would, to try it out*/
+    alarm_out_play((alarm_pattern_t)pattern);
+    console_put_line("\r\nok\r\n");
+}
+#endif
+
+static void cmd_stats(int argc, char **argv)
+{
+    char line[COMMAND_REPLY];
+    console_stats_t console;
+    uint32_t wakeups;
+    uint32_t uptime;
+
+    console_get_stats(&console);
+    snprintf(line, sizeof(line), "\r\nconsole written %lu dropped %lu\r\n",
+             (unsigned long)console.written, (unsigned long)console.dropped);
+    console_put_line(line);
+    /**the tickless idle figure, a plain tick build wakes 720000 times an hour*/
+    wakeups = low_power_get_wakeups();
+    uptime = xTaskGetTickCount() / configTICK_RATE_HZ;
+    snprintf(line, sizeof(line), "wakeups %lu in %lu s up, %lu per hour\r\n",
+             (unsigned long)wakeups, (unsigned long)uptime,
+             (unsigned long)(uptime ? (uint64_t)wakeups * 3600U / uptime : 0U));
+    console_put_line(line);
+#if APP_STATS
+    stats_dump();
+#endif
+}
+
+static void cmd_boot(int argc, char **argv)
+{
+    boot_report();
+}
+
+#if APP_TRACE
+static void cmd_trace(int argc, char **argv)
+{
+    trace_dump();
+}
+#endif
+
+static const command_t commands[] = {
+    { "set-time", 2, 2, cmd_set_time },
+    { "set-date", 2, 2, cmd_set_date },
+    { "set-alarm", 2, 3, cmd_set_alarm },
+    { "del-alarm", 2, 2, cmd_del_alarm },
+    { "list", 1, 1, cmd_list },
+    { "zones", 1, 2, cmd_zones },
+#if APP_HRTIMER
+    { "stopwatch", 1, 2, cmd_stopwatch },
+    { "countdown", 1, 3, cmd_countdown },
+#endif
+#if APP_ALARM_OUT
+    { "snooze", 1, 1, cmd_snooze },
+    { "alarm-off", 1, 1, cmd_alarm_off },
+    { "ring", 1, 2, cmd_ring },
+#endif
+    { "stats", 1, 1, cmd_stats },
+    { "boot", 1, 1, cmd_boot },
+#if APP_TRACE
+    { "trace", 1, 1, cmd_trace },
+#endif
+};
+
+void command_execute(char *line)
+{
+    char *argv[COMMAND_ARGS_MAX];
+    int argc = 0;
+    size_t i;
+
+    /**split the words in place*/
+    for (;;)
+    {
+        while (' ' == *line)
+        {
+            *line++ = '\0';
+        }
+        if ('\0' == *line)
+        {
+            break;
+        }
+        if (COMMAND_ARGS_MAX == argc)
+        {
+            console_put_line("\r\ntoo many arguments\r\n");
+            return;
+        }
+        argv[argc++] = line;
+        while ((' ' != *line) && ('\0' != *line))
+        {
+            line++;
+        }
+    }
+    if (0 == argc)
+    {
+        return;
+    }
+    for (i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+    {
+        if (0 == strcmp(argv[0], commands[i].name))
+        {
+            if ((argc < commands[i].min_argc) || (argc > commands[i].max_argc))
+            {
+                console_put_line("\r\nwrong number of arguments\r\n");
+                return;
+            }
+            commands[i].handler(argc, argv);
+            return;
+        }
+    }
+    console_put_line("\r\nunknown command\r\n");
+}
+
+void command_task(void *args)
+{
+    /*
+     * Sleeps in console_port_read until the UART interrupt has a byte,
+     * collects a line and runs it. A line longer than the buffer is
+     * discarded whole.
+     */
+    static char line[COMMAND_LINE_MAX + 1];
+    size_t len = 0;
+    bool overflow = false;
+    char byte;
+
+    for (;;)
+    {
+        byte = console_port_read();
+        if (('\r' == byte) || ('\n' == byte))
+        {
+#if !APP_BINLOG
+            /**the terminal's local echo of the line may have landed in the rows*/
+            stats_semaphore_take(mutex_screen, portMAX_DELAY, STATS_WAIT_SCREEN);
+            vt100_render_invalidate();
+            xSemaphoreGive(mutex_screen);
+#endif
+            if (overflow)
+            {
+                console_put_line("\r\nline too long\r\n");
+            } else
+            {
+                line[len] = '\0';
+                command_execute(line);
+            }
+            len = 0;
+            overflow = false;
+        } else if (('\b' == byte) || (0x7f == byte))
+        {
+            if (len > 0)
+            {
+                len--;
+            }
+        } else if (len < COMMAND_LINE_MAX)
+        {
+            line[len++] = byte;
+        } else
+        {
+            overflow = true;
+        }
+    }
+}
@@ -0,0 +1,38 @@
+/**
+ * @file    command.h
+ * @brief   Console command interface.
+ *
+ * Lines typed on the debug UART are collected by command_task straight
+ * from the interrupt driven receive ring and parsed in place: the words are
+ * split by terminating them inside the line buffer, nothing is copied.
+ *
+ *   set-time HH:MM:SS     moves the clock, it keeps running
+ *   set-date YYYY-MM-DD   moves the clock to another date, same time
+ *   set-alarm HH:MM:SS [YYYY-MM-DD|daily|weekdays|weekends|mon,tue,...]
+ *                         adds an alarm, daily by default
+ *   del-alarm ID          removes an alarm
+ *   list                  shows the time and the alarm table
+ *   zones [none|all|NYC,MAD,...]
+ *                         lists the time zones, or picks the ones shown
+ *   stopwatch [start|stop|reset]
+ *                         shows the stopwatch, to the microsecond
+ *   countdown [MS|cancel ID]
+ *                         lists, starts or cancels countdowns
+ *   stats                 shows the console counters (and APP_STATS dump)
+ *   boot                  shows the boot timeline, microseconds since reset
+ *   trace                 dumps the latency trace (APP_TRACE builds)
+ */
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+#define COMMAND_LINE_MAX 48 /**longest accepted line, terminator excluded*/
+#define COMMAND_ARGS_MAX 3  /**words of the longest command*/
+
+/**executes one line, it is modified in place*/
+void command_execute(char *line);
+
+/**reads command lines from the console, created at a low priority*/
+void command_task(void *args);
+
+#endif /* COMMAND_H_ */
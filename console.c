@@ -0,0 +1,254 @@
+/**
+ * @file    console.c
+ * @brief   Asynchronous console output through a ring buffer.
+ *
+ * A write reserves and fills its space inside one short critical section,
+ * bounded by the length of the write. On this single core that gives every
+ * producing task a fixed worst case without a lock that another task could
+ * hold, and it lets drop-oldest move the tail safely under the reader.
+ */
+
+#include "console.h"
+
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace.h"
+#include "stats.h"
+#include "binlog.h"
+#include "vt100_render.h"
+#include "crash.h"
+
+#define RING_MASK (CONSOLE_RING_SIZE - 1)
+
+static char ring[CONSOLE_RING_SIZE];
+static uint32_t head;   /**free running write index*/
+static uint32_t tail;   /**free running read index*/
+static console_policy_t overflow_policy;
+static console_stats_t counters;
+static TaskHandle_t console_handle;
+
+#if APP_TRACE
+#define CONSOLE_MARKS 4 /**traced writes waiting to leave the UART*/
+
+/**type definition for a tracepoint due once a write has been sent*/
+typedef struct {
+    uint32_t end;       /**ring index just past the traced write*/
+    uint32_t arg;
+    uint8_t event;
+} console_mark_t;
+
+static console_mark_t marks[CONSOLE_MARKS];
+static uint8_t mark_count;
+#endif
+
+void console_init(console_policy_t policy)
+{
+    taskENTER_CRITICAL();
+    head = 0;
+    tail = 0;
+    overflow_policy = policy;
+    memset(&counters, 0, sizeof(counters));
+    taskEXIT_CRITICAL();
+}
+
+/**copies a write into the ring, must be called inside a critical section*/
+static size_t ring_put(const char *data, size_t len)
+{
+    uint32_t used;
+    uint32_t index;
+    size_t first;
+
+    if ((0 == len) || (len > CONSOLE_RING_SIZE))
+    {
+        counters.dropped += len;
+        return 0;
+    }
+    used = head - tail;
+    if (len > CONSOLE_RING_SIZE - used)
+    {
+        if (CONSOLE_DROP_NEWEST == overflow_policy)
+        {
+            counters.dropped += len;
+            return 0;
+        }
+        /**drop oldest: the unsent bytes that are in the way are discarded*/
+        counters.dropped += len - (CONSOLE_RING_SIZE - used);
+        tail += len - (CONSOLE_RING_SIZE - used);
+    }
+    index = head & RING_MASK;
+    first = CONSOLE_RING_SIZE - index;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(&ring[index], data, first);
+    memcpy(&ring[0], data + first, len - first);
+    head += len;
+    counters.written += len;
+    if (head - tail > counters.high_water)
+    {
+        counters.high_water = head - tail;
+    }
+    return len;
+}
+
+/**wakes the writer once something has been queued*/
+static void wake_writer(size_t accepted)
+{
+    if (accepted && (NULL != console_handle))
+    {
+        xTaskNotifyGive(console_handle);
+    }
+}
+
+size_t console_write(const char *data, size_t len)
+{
+    size_t accepted;
+
+    taskENTER_CRITICAL();
+    accepted = ring_put(data, len);
+    taskEXIT_CRITICAL();
+    wake_writer(accepted);
+    return accepted;
+}
+
+void console_put_line(const char *line)
+{
+#if APP_BINLOG
+    /**no screen, the host decoder passes the text through*/
+    size_t len = strlen(line);
+
+    while (0 == console_write(line, len))
+    {
+        vTaskDelay(1);
+    }
+#else
+    char text[CONSOLE_LINE_MAX + RENDER_TEXT_FRAME + 1]; /**with the cursor commands*/
+    size_t len;
+
+    while ('\0' != *line)
+    {
+        len = vt100_render_text(text, sizeof(text), line);
+        /**the lock is dropped while waiting, the clock keeps being drawn*/
+        for (;;)
+        {
+            stats_semaphore_take(mutex_screen, portMAX_DELAY, STATS_WAIT_SCREEN);
+            if (0 != console_write(text, len))
+            {
+                break;
+            }
+            xSemaphoreGive(mutex_screen);
+            vTaskDelay(1);
+        }
+        xSemaphoreGive(mutex_screen);
+        line += len - RENDER_TEXT_FRAME;
+    }
+#endif
+}
+
+#if APP_TRACE
+size_t console_write_traced(const char *data, size_t len, uint8_t event,
+                            uint32_t arg)
+{
+    size_t accepted;
+
+    taskENTER_CRITICAL();
+    accepted = ring_put(data, len);
+    if (accepted && (mark_count < CONSOLE_MARKS))
+    {
+        marks[mark_count].end = head;
+        marks[mark_count].arg = arg;
+        marks[mark_count].event = event;
+        mark_count++;
+    }
+    taskEXIT_CRITICAL();
+    wake_writer(accepted);
+    return accepted;
+}
+
+/**emits the tracepoints of the writes that have completely left the UART*/
+static void marks_sent(uint32_t sent)
+{
+    uint8_t i = 0;
+
+    while (i < mark_count)
+    {
+        taskENTER_CRITICAL();
+        if ((int32_t)(sent - marks[i].end) >= 0)
+        {
+            console_mark_t mark = marks[i];
+
+            marks[i] = marks[--mark_count];
+            taskEXIT_CRITICAL();
+            trace_point((trace_event_t)mark.event, mark.arg);
+            continue;
+        }
+        taskEXIT_CRITICAL();
+        i++;
+    }
+}
+#endif
+
+void console_get_stats(console_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = counters;
+    taskEXIT_CRITICAL();
+}
+
+/**moves up to CONSOLE_CHUNK bytes out of the ring, returns how many*/
+static size_t take_chunk(char *chunk, uint32_t *end)
+{
+    size_t len;
+    size_t first;
+    uint32_t index;
+
+    taskENTER_CRITICAL();
+    len = head - tail;
+    if (len > CONSOLE_CHUNK)
+    {
+        len = CONSOLE_CHUNK;
+    }
+    index = tail & RING_MASK;
+    first = CONSOLE_RING_SIZE - index;
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(chunk, &ring[index], first);
+    memcpy(chunk + first, &ring[0], len - first);
+    tail += len;
+    *end = tail;
+    taskEXIT_CRITICAL();
+    return len;
+}
+
+void console_task(void *args)
+{
+    static char chunk[CONSOLE_CHUNK];
+    size_t len;
+    uint32_t end;
+
+    /*
+     * Writes the ring out a chunk at a time
+     * so the UART is never driven inside a critical section,
+     * then sleeps until a producer queues something.
+     */
+    console_port_start();
+    /**post-mortem of a HardFault in the previous run, ahead of anything queued*/
+    crash_report();
+    console_handle = xTaskGetCurrentTaskHandle();
+    for (;;)
+    {
+        while (0 != (len = take_chunk(chunk, &end)))
+        {
+            console_port_write(chunk, len);
+#if APP_TRACE
+            marks_sent(end);
+#endif
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * @file    console.h
+ * @brief   Asynchronous console output.
+ *
+ * Producers copy their bytes into a ring buffer and return in bounded time;
+ * console_task, at the lowest priority, drains the ring to the UART. No
+ * producer ever waits for the UART.
+ */
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "trace.h"
+
+#define CONSOLE_RING_SIZE 512   /**ring buffer bytes, a power of two*/
+#define CONSOLE_CHUNK 64        /**bytes handed to the UART per write*/
+#define CONSOLE_LINE_MAX 64     /**longest piece of a console_put_line write*/
+
+/**what to do with a write that does not fit in the ring*/
+typedef enum {
+    CONSOLE_DROP_NEWEST,    /**the new write is dropped whole*/
+    CONSOLE_DROP_OLDEST     /**the oldest unsent bytes make room for it*/
+} console_policy_t;
+
+/**overflow policy used by console_init*/
+#ifndef CONSOLE_POLICY
+#define CONSOLE_POLICY CONSOLE_DROP_NEWEST
+#endif
+
+/**type definition for the console counters*/
+typedef struct {
+    uint32_t written;       /**bytes accepted into the ring*/
+    uint32_t dropped;       /**bytes lost to the overflow policy*/
+    uint32_t high_water;    /**most bytes ever waiting in the ring*/
+} console_stats_t;
+
+/**empties the ring and selects the overflow policy*/
+void console_init(console_policy_t policy);
+
+/**queues len bytes for the UART, returns how many were accepted*/
+size_t console_write(const char *data, size_t len);
+
+/**screen lock of Reloj_Alarma.c, the renderer and the terminal cursor*/
+extern SemaphoreHandle_t mutex_screen;
+
+/**
+ * Queues one line of text, waiting for room so a long listing is never cut
+ * short. On the VT100 screen it goes to the scrolling area below the rows
+ * of the renderer, under mutex_screen, in pieces of up to CONSOLE_LINE_MAX
+ * bytes; each piece resumes at the cursor the previous one saved.
+ */
+void console_put_line(const char *line);
+
+#if APP_TRACE
+/**like console_write, and records the tracepoint once the bytes left the UART*/
+size_t console_write_traced(const char *data, size_t len, uint8_t event,
+                            uint32_t arg);
+#endif
+
+/**copies the counters*/
+void console_get_stats(console_stats_t *stats);
+
+/**drains the ring to the UART, created at the lowest priority*/
+void console_task(void *args);
+
+/**prepares the UART transmitter, provided by the board layer*/
+void console_port_init(void);
+
+/**
+ * Board set up the clock does not wait for, run by console_task before its
+ * first write, provided by the board layer. It clears the terminal.
+ */
+void console_port_start(void);
+
+/**UART write used by console_task, returns once the bytes are sent*/
+void console_port_write(const char *data, size_t len);
+
+/**waits for and returns the next byte received by the UART*/
+char console_port_read(void);
+
+#endif /* CONSOLE_H_ */
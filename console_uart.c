@@ -0,0 +1,93 @@
+/**
+ * @file    console_uart.c
+ * @brief   Interrupt driven UART transmitter and receiver behind the console.
+ *
+ * The bytes go out through the fsl_uart transactional API; console_task
+ * sleeps on a semaphore until the TX complete callback, so the CPU is free
+ * (or asleep) while the debug UART shifts the data out. Received bytes are
+ * collected by the UART interrupt into a small ring buffer and a reader
+ * sleeps until one arrives.
+ */
+
+#include "console.h"
+
+#include "board.h"
+#include "peripherals.h"
+#include "fsl_uart.h"
+#include "fsl_debug_console.h"
+#include "app_rtos.h"
+
+#define RX_RING_SIZE 32 /**bytes buffered by the UART interrupt*/
+
+static uart_handle_t uart_handle;
+static SemaphoreHandle_t tx_done_semaphore;
+static SemaphoreHandle_t rx_done_semaphore;
+static uint8_t rx_ring[RX_RING_SIZE];
+
+static void uart_callback(UART_Type *base, uart_handle_t *handle,
+                        status_t status, void *user_data)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (kStatus_UART_TxIdle == status)
+    {
+        xSemaphoreGiveFromISR(tx_done_semaphore, &woken);
+    } else if (kStatus_UART_RxIdle == status)
+    {
+        xSemaphoreGiveFromISR(rx_done_semaphore, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+void console_port_init(void)
+{
+    APP_BINARY_SEMAPHORE_CREATE(tx_done_semaphore);
+    APP_BINARY_SEMAPHORE_CREATE(rx_done_semaphore);
+    UART_TransferCreateHandle((UART_Type *)BOARD_DEBUG_UART_BASEADDR,
+                              &uart_handle, uart_callback, NULL);
+    UART_TransferStartRingBuffer((UART_Type *)BOARD_DEBUG_UART_BASEADDR,
+                                 &uart_handle, rx_ring, sizeof(rx_ring));
+    /**the callback uses the FreeRTOS FromISR API*/
+    NVIC_SetPriority(BOARD_UART_IRQ,
+                     configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1);
+}
+
+void console_port_start(void)
+{
+    BOARD_InitBootPeripherals();
+    PRINTF("\033[2J"); /**clear screen VT100 command*/
+}
+
+void console_port_write(const char *data, size_t len)
+{
+    uart_transfer_t transfer;
+
+    transfer.data = (uint8_t *)data;
+    transfer.dataSize = len;
+    if (kStatus_Success
+            == UART_TransferSendNonBlocking((UART_Type *)BOARD_DEBUG_UART_BASEADDR,
+                                            &uart_handle, &transfer))
+    {
+        xSemaphoreTake(tx_done_semaphore, portMAX_DELAY);
+    }
+}
+
+char console_port_read(void)
+{
+    uart_transfer_t transfer;
+    size_t received = 0;
+    uint8_t byte;
+
+    transfer.data = &byte;
+    transfer.dataSize = 1;
+    if ((kStatus_Success
+            == UART_TransferReceiveNonBlocking((UART_Type *)BOARD_DEBUG_UART_BASEADDR,
+                                               &uart_handle, &transfer,
+                                               &received))
+            && (0 == received))
+    {
+        /**nothing buffered yet, the interrupt completes the transfer*/
+        xSemaphoreTake(rx_done_semaphore, portMAX_DELAY);
+    }
+    return (char)byte;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file    crash.c
+ * @brief   Fault record sealing and the boot time crash report.
+ *
+ * The report is four lines below the clock:
+ *   CRASH <task> pc <pc> lr <lr> psr <xpsr>
+ *   CFSR <cfsr> HFSR <hfsr> MMFAR <mmfar> BFAR <bfar> EXC <exc_return>
+ *   R0 <r0> R1 <r1> R2 <r2> R3 <r3> R12 <r12>
+ *   EV <event>:<arg> ...       breadcrumbs, oldest first
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "crash.h"
+#include "app_config.h"
+#include "fsl_debug_console.h"
+
+CRASH_NOINIT crash_record_t crash_record;
+CRASH_NOINIT crash_event_t crash_events[CRASH_EVENTS];
+CRASH_NOINIT uint32_t crash_event_count;
+
+/**CRC-32 (reflected 0xEDB88320) of the record past its header*/
+static uint32_t record_crc(const crash_record_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record + offsetof(crash_record_t, stacked);
+    size_t len = sizeof(*record) - offsetof(crash_record_t, stacked);
+    uint32_t crc = 0xFFFFFFFFU;
+    uint8_t bit;
+
+    while (len--)
+    {
+        crc ^= *bytes++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+void crash_seal(crash_record_t *record)
+{
+    uint32_t count = crash_event_count;
+    uint8_t i;
+
+    for (i = 0; i < CRASH_EVENTS; i++)
+    {
+        record->events[i] = crash_events[(count + i) & (CRASH_EVENTS - 1U)];
+    }
+    record->crc = record_crc(record);
+    record->magic = CRASH_MAGIC;
+}
+
+bool crash_report(void)
+{
+    const crash_record_t *record = &crash_record;
+    const uint32_t *r = record->stacked;
+    uint8_t i;
+
+    /**the breadcrumbs of this run start from a known state either way*/
+    memset(crash_events, 0, sizeof(crash_events));
+    crash_event_count = 0;
+    if ((CRASH_MAGIC != record->magic) || (record_crc(record) != record->crc))
+    {
+        crash_record.magic = 0;
+        return false;
+    }
+    crash_record.magic = 0;
+
+    PRINTF("\033[%d;1HCRASH %.*s pc %08lx lr %08lx psr %08lx\r\n",
+           CRASH_ROW, CRASH_TASK_NAME, record->task,
+           (unsigned long)r[6], (unsigned long)r[5], (unsigned long)r[7]);
+    PRINTF("CFSR %08lx HFSR %08lx MMFAR %08lx BFAR %08lx EXC %08lx\r\n",
+           (unsigned long)record->cfsr, (unsigned long)record->hfsr,
+           (unsigned long)record->mmfar, (unsigned long)record->bfar,
+           (unsigned long)record->exc_return);
+    PRINTF("R0 %08lx R1 %08lx R2 %08lx R3 %08lx R12 %08lx\r\nEV",
+           (unsigned long)r[0], (unsigned long)r[1], (unsigned long)r[2],
+           (unsigned long)r[3], (unsigned long)r[4]);
+    for (i = 0; i < CRASH_EVENTS; i++)
+    {
+        PRINTF(" %u:%lu", record->events[i].event,
+               (unsigned long)record->events[i].arg);
+    }
+    PRINTF("\r\n");
+    return true;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file    crash.h
+ * @brief   HardFault capture kept in no-init RAM across the reset.
+ *
+ * Every tracepoint also leaves a breadcrumb in a small ring that is never
+ * cleared by the startup code. When a fault other than a semihosting
+ * BKPT reaches HardFault_Handler, the stacked registers, the fault status
+ * registers, the running task and the breadcrumbs are sealed with a magic
+ * and a CRC and the MCU is reset. crash_report() prints the record once,
+ * on the next boot, before the scheduler starts.
+ */
+
+#ifndef CRASH_H_
+#define CRASH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CRASH_EVENTS 8          /**breadcrumbs kept, a power of two*/
+#define CRASH_TASK_NAME 12      /**characters of the task name kept*/
+#define CRASH_MAGIC 0xC4A5E0F7U /**marks a sealed record*/
+
+/**no-init RAM, placed by the MCUXpresso managed linker script*/
+#define CRASH_NOINIT __attribute__((section(".noinit")))
+
+/**type definition for one breadcrumb*/
+typedef struct {
+    uint32_t arg;
+    uint8_t event;  /**trace_event_t*/
+} crash_event_t;
+
+/**type definition for the sealed fault record*/
+typedef struct {
+    uint32_t magic;
+    uint32_t crc;           /**CRC-32 of the fields below*/
+    uint32_t stacked[8];    /**r0, r1, r2, r3, r12, lr, pc, xpsr*/
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uint32_t exc_return;    /**LR on entry, tells thread or handler mode*/
+    char task[CRASH_TASK_NAME];
+    crash_event_t events[CRASH_EVENTS];  /**oldest first*/
+} crash_record_t;
+
+extern CRASH_NOINIT crash_record_t crash_record;
+extern CRASH_NOINIT crash_event_t crash_events[CRASH_EVENTS];
+extern CRASH_NOINIT uint32_t crash_event_count;
+
+/**leaves a breadcrumb, two stores and an increment; a preempted call can
+ * at worst lose one breadcrumb*/
+static inline void crash_event(uint8_t event, uint32_t arg)
+{
+    crash_event_t *slot = &crash_events[crash_event_count++ & (CRASH_EVENTS - 1U)];
+
+    slot->arg = arg;
+    slot->event = event;
+}
+
+/**fills the breadcrumbs of a record and seals it, called by the fault handler*/
+void crash_seal(crash_record_t *record);
+
+/**prints and discards a record left by the previous run, true if there was one*/
+bool crash_report(void);
+
+#endif /* CRASH_H_ */
@@ -0,0 +1,146 @@
+/*
+ * FreeRTOSConfig.h for the host simulation build.
+ *
+ * Mirrors the MK64F12 configuration in ../FreeRTOSConfig.h where it matters
+ * to the application (priorities, stack sizes, features) and replaces the
+ * Cortex-M specific parts with what the FreeRTOS POSIX/Linux port needs.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/**host tick rate; a high rate lets CLOCK_TIME_SCALE accelerate the clock*/
+#ifndef HOST_TICK_RATE_HZ
+#define HOST_TICK_RATE_HZ 10000
+#endif
+
+#define configUSE_PREEMPTION                    1
+#ifdef HOST_SIM
+/* The simulation harness jumps the tick over idle periods, see
+sim_harness.c. vTaskStepTick must accept a jump that lands exactly on the
+next unblock time, which needs FreeRTOS-Kernel V10.5 or later. */
+#define configUSE_TICKLESS_IDLE                 1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
+#define portSUPPRESS_TICKS_AND_SLEEP(idle) \
+    do { \
+        extern void sim_fast_forward(TickType_t idle_ticks); \
+        sim_fast_forward(idle); \
+    } while (0)
+#else
+#define configUSE_TICKLESS_IDLE                 0
+#endif
+#define configCPU_CLOCK_HZ                      ((unsigned long)1000000)
+#define configTICK_RATE_HZ                      ((TickType_t)HOST_TICK_RATE_HZ)
+#define configMAX_PRIORITIES                    5
+#define configMINIMAL_STACK_SIZE                ((unsigned short)PTHREAD_STACK_MIN)
+#define configMAX_TASK_NAME_LEN                 20
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configQUEUE_REGISTRY_SIZE               8
+#define configUSE_QUEUE_SETS                    0
+#define configUSE_TIME_SLICING                  0
+#define configUSE_NEWLIB_REENTRANT              0
+#define configENABLE_BACKWARD_COMPATIBILITY     1
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+#define configUSE_APPLICATION_TASK_TAG          0
+
+/* Memory allocation related definitions. */
+/* APP_STATIC_ALLOCATION creates every kernel object from static storage,
+see app_rtos.h. Dynamic allocation stays enabled so heap_4.c still builds,
+but nothing is allocated from the heap in that mode. */
+#ifndef APP_STATIC_ALLOCATION
+#define APP_STATIC_ALLOCATION                   0
+#endif
+#define configSUPPORT_STATIC_ALLOCATION         APP_STATIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#if APP_STATIC_ALLOCATION
+#define configTOTAL_HEAP_SIZE                   ((size_t)(64))
+#else
+#define configTOTAL_HEAP_SIZE                   ((size_t)(8 * 1024 * 1024))
+#endif
+#define configAPPLICATION_ALLOCATED_HEAP        0
+
+/* APP_CLOCK_RTC=1 takes the time from the simulated RTC of board_stubs.c,
+ * which counts clock seconds in the tick hook as the host has no RTC. */
+#ifndef APP_CLOCK_RTC
+#define APP_CLOCK_RTC                           0
+#endif
+
+/* APP_HRTIMER=1 checks the countdown deadline of hrtimer_host.c in the tick
+ * hook, standing in for the compare interrupt. */
+#ifndef APP_HRTIMER
+#define APP_HRTIMER                             1
+#endif
+
+/* APP_ALARM_OUT=1 runs the alarm output step timer of alarm_out_host.c in
+ * the tick hook, standing in for the PIT interrupt. */
+#ifndef APP_ALARM_OUT
+#define APP_ALARM_OUT                           1
+#endif
+
+/* Hook function related definitions. */
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     (APP_CLOCK_RTC || APP_HRTIMER || APP_ALARM_OUT)
+#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK      0
+
+/* Run time and task stats gathering related definitions. */
+#ifndef APP_STATS
+#define APP_STATS                               0
+#endif
+#define configGENERATE_RUN_TIME_STATS           APP_STATS
+#define configUSE_TRACE_FACILITY                1
+#define configUSE_STATS_FORMATTING_FUNCTIONS    0
+#if APP_STATS
+void stats_timer_init(void);
+unsigned long stats_timer_read(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() stats_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()        stats_timer_read()
+#endif
+
+/* Co-routine related definitions. */
+#define configUSE_CO_ROUTINES                   0
+#define configMAX_CO_ROUTINE_PRIORITIES         2
+
+/* Software timer related definitions. */
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               (configMAX_PRIORITIES - 1)
+#define configTIMER_QUEUE_LENGTH                10
+#define configTIMER_TASK_STACK_DEPTH            (configMINIMAL_STACK_SIZE * 2)
+
+/* Define to trap errors during development. */
+#define configASSERT(x) if((x) == 0) {vAssertCalled(__FILE__, __LINE__);}
+void vAssertCalled(const char *file, unsigned long line);
+
+/* Optional functions. */
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_xTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_uxTaskGetStackHighWaterMark     APP_STATS
+#define INCLUDE_xTaskGetIdleTaskHandle          0
+#define INCLUDE_eTaskGetState                   0
+#define INCLUDE_xTimerPendFunctionCall          1
+#define INCLUDE_xTaskAbortDelay                 0
+#define INCLUDE_xTaskGetHandle                  0
+#define INCLUDE_xTaskResumeFromISR              1
+
+/* The IPC benchmark counts context switches. */
+#ifdef BENCH_IPC
+extern volatile unsigned long bench_switches;
+#define traceTASK_SWITCHED_IN() bench_switches++
+#endif
+
+#include <limits.h> /* PTHREAD_STACK_MIN */
+
+#endif /* FREERTOS_CONFIG_H */
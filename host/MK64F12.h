@@ -0,0 +1,11 @@
+/*
+ * Host stand-in for the MK64F12 device header.
+ * Only the standard types the application relies on are provided.
+ */
+
+#ifndef _MK64F12_H_
+#define _MK64F12_H_
+
+#include <stdint.h>
+
+#endif /* _MK64F12_H_ */
@@ -0,0 +1,103 @@
+/*
+ * Host stand-in for the buzzer PWM, LED and step timer of alarm_out_ftm.c.
+ *
+ * Nothing is played; every change of tone or LED is recorded with its time
+ * so a test can check the waveform. The step timer is the tick hook, which
+ * in the virtual time simulation may run long after a deadline when ticks
+ * were skipped. Each step is therefore timed from the deadline of the one
+ * before, not from the tick that handled it, and the recorded times are
+ * exact whatever the tick rate.
+ */
+
+#include <stddef.h>
+
+#include "alarm_out.h"
+#include "alarm_out_host.h"
+#include "task.h"
+
+#if APP_ALARM_OUT
+
+static alarm_out_event_t timeline[ALARM_OUT_HOST_EVENTS];
+static uint32_t recorded;
+static alarm_out_event_t output;    /**what is being played*/
+static uint64_t deadline;
+static uint64_t fired = UINT64_MAX; /**deadline being handled, if any*/
+static bool armed;
+
+static uint64_t tick_ms(void)
+{
+    return (uint64_t)xTaskGetTickCountFromISR() * 1000U / configTICK_RATE_HZ;
+}
+
+/**time of a change: the deadline inside the timer, the tick otherwise*/
+static uint64_t change_ms(void)
+{
+    return (UINT64_MAX != fired) ? fired : tick_ms();
+}
+
+/**records the output once it changed, changes at one time make one event*/
+static void record(void)
+{
+    alarm_out_event_t *last = recorded
+            ? &timeline[(recorded - 1U) % ALARM_OUT_HOST_EVENTS] : NULL;
+
+    output.ms = change_ms();
+    if ((NULL != last) && (last->ms == output.ms))
+    {
+        *last = output;
+    } else if ((NULL == last) || (last->tone_hz != output.tone_hz)
+            || (last->led != output.led))
+    {
+        timeline[recorded++ % ALARM_OUT_HOST_EVENTS] = output;
+    }
+}
+
+void alarm_out_port_init(void)
+{
+}
+
+void alarm_out_port_tone(uint16_t hz)
+{
+    output.tone_hz = hz;
+    record();
+}
+
+void alarm_out_port_led(bool on)
+{
+    output.led = on;
+    record();
+}
+
+void alarm_out_port_timer(uint32_t ms)
+{
+    deadline = change_ms() + ms;
+    armed = (0 != ms);
+}
+
+void alarm_out_host_tick(void)
+{
+    /**catches up on every step due, skipped ticks included*/
+    while (armed && (tick_ms() >= deadline))
+    {
+        armed = false;
+        fired = deadline;
+        alarm_out_step_from_isr();
+        fired = UINT64_MAX;
+    }
+}
+
+uint32_t alarm_out_host_events(void)
+{
+    return recorded;
+}
+
+const alarm_out_event_t *alarm_out_host_event(uint32_t index)
+{
+    if ((index >= recorded) || (recorded - index > ALARM_OUT_HOST_EVENTS))
+    {
+        return NULL;
+    }
+    return &timeline[index % ALARM_OUT_HOST_EVENTS];
+}
+
+#endif /* APP_ALARM_OUT */
@@ -0,0 +1,29 @@
+/*
+ * Waveform timeline recorded by the host stand-in of the alarm output.
+ */
+
+#ifndef ALARM_OUT_HOST_H_
+#define ALARM_OUT_HOST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ALARM_OUT_HOST_EVENTS 64    /**newest changes kept*/
+
+/**the output from ms on, until the next event*/
+typedef struct {
+    uint64_t ms;        /**kernel tick time of the change*/
+    uint16_t tone_hz;   /**0 is silence*/
+    bool led;
+} alarm_out_event_t;
+
+/**changes recorded since the start, the older ones are overwritten*/
+uint32_t alarm_out_host_events(void);
+
+/**one change by its number, NULL once it has been overwritten*/
+const alarm_out_event_t *alarm_out_host_event(uint32_t index);
+
+/**step timer of the stand-in, called from the tick hook*/
+void alarm_out_host_tick(void);
+
+#endif /* ALARM_OUT_HOST_H_ */
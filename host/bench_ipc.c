@@ -0,0 +1,192 @@
+/*
+ * IPC micro-benchmark for the kernel primitives Reloj_Alarma uses.
+ *
+ * A driver task hands control to a higher priority partner task and waits
+ * for the answer, so every round trip is two hand-offs. Each pattern is
+ * timed over BENCH_ROUNDS round trips and the context switches are counted
+ * with traceTASK_SWITCHED_IN. The mutex has no partner: it is only ever
+ * taken and given by one task at a time in the application.
+ *
+ * Output is one JSON object per line:
+ *   {"pattern":"...","rounds":N,"ns_per_round":X,"switches_per_round":Y}
+ *
+ * The figures are for the POSIX port on the build machine; they rank the
+ * primitives against each other, they are not MCU cycle counts.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "event_groups.h"
+
+#ifndef BENCH_ROUNDS
+#define BENCH_ROUNDS 20000
+#endif
+
+#define PING_BIT (1 << 0)
+#define PONG_BIT (1 << 1)
+
+/**type definition for the hand-off patterns being compared*/
+typedef enum {
+    PATTERN_BINARY_SEMAPHORE,
+    PATTERN_EVENT_GROUP,
+    PATTERN_QUEUE,
+    PATTERN_TASK_NOTIFICATION,
+    PATTERN_MUTEX,
+    PATTERN_COUNT
+} bench_pattern_t;
+
+static const char *const pattern_names[PATTERN_COUNT] = {
+    "binary_semaphore",
+    "event_group",
+    "pointer_queue",
+    "task_notification",
+    "mutex_uncontended"
+};
+
+volatile unsigned long bench_switches;
+
+static SemaphoreHandle_t ping_semaphore;
+static SemaphoreHandle_t pong_semaphore;
+static SemaphoreHandle_t mutex;
+static EventGroupHandle_t events;
+static QueueHandle_t ping_queue;
+static QueueHandle_t pong_queue;
+static TaskHandle_t driver_handle;
+static TaskHandle_t partner_handle;
+static volatile bench_pattern_t pattern;
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**one hand-off from the driver to the partner and back*/
+static void round_trip(void)
+{
+    void *message = NULL;
+
+    switch (pattern)
+    {
+        case PATTERN_BINARY_SEMAPHORE:
+            xSemaphoreGive(ping_semaphore);
+            xSemaphoreTake(pong_semaphore, portMAX_DELAY);
+        break;
+        case PATTERN_EVENT_GROUP:
+            xEventGroupSetBits(events, PING_BIT);
+            xEventGroupWaitBits(events, PONG_BIT, pdTRUE, pdTRUE, portMAX_DELAY);
+        break;
+        case PATTERN_QUEUE:
+            xQueueSend(ping_queue, &message, portMAX_DELAY);
+            xQueueReceive(pong_queue, &message, portMAX_DELAY);
+        break;
+        case PATTERN_TASK_NOTIFICATION:
+            xTaskNotifyGive(partner_handle);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        break;
+        case PATTERN_MUTEX:
+            xSemaphoreTake(mutex, portMAX_DELAY);
+            xSemaphoreGive(mutex);
+        break;
+        default:
+        break;
+    }
+}
+
+static void partner_task(void *args)
+{
+    const bench_pattern_t answered = (bench_pattern_t)(intptr_t)args;
+    void *message;
+
+    for (;;)
+    {
+        switch (answered)
+        {
+            case PATTERN_BINARY_SEMAPHORE:
+                xSemaphoreTake(ping_semaphore, portMAX_DELAY);
+                xSemaphoreGive(pong_semaphore);
+            break;
+            case PATTERN_EVENT_GROUP:
+                xEventGroupWaitBits(events, PING_BIT, pdTRUE, pdTRUE,
+                                    portMAX_DELAY);
+                xEventGroupSetBits(events, PONG_BIT);
+            break;
+            case PATTERN_QUEUE:
+                xQueueReceive(ping_queue, &message, portMAX_DELAY);
+                xQueueSend(pong_queue, &message, portMAX_DELAY);
+            break;
+            case PATTERN_TASK_NOTIFICATION:
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                xTaskNotifyGive(driver_handle);
+            break;
+            default:
+                /**nothing to answer*/
+                vTaskSuspend(NULL);
+            break;
+        }
+    }
+}
+
+static void driver_task(void *args)
+{
+    bench_pattern_t current;
+    unsigned long switches;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t round;
+
+    for (current = 0; current < PATTERN_COUNT; current++)
+    {
+        pattern = current;
+        /**a fresh partner per pattern, above the driver so every give is a hand-off*/
+        xTaskCreate(partner_task, "Partner", configMINIMAL_STACK_SIZE,
+                    (void *)(intptr_t)current, configMAX_PRIORITIES - 1,
+                    &partner_handle);
+        configASSERT(partner_handle);
+
+        switches = bench_switches;
+        start = now_ns();
+        for (round = 0; round < BENCH_ROUNDS; round++)
+        {
+            round_trip();
+        }
+        elapsed = now_ns() - start;
+        switches = bench_switches - switches;
+        vTaskDelete(partner_handle);
+
+        printf("{\"pattern\":\"%s\",\"rounds\":%u,\"ns_per_round\":%.1f,"
+               "\"switches_per_round\":%.2f}\n",
+               pattern_names[current], BENCH_ROUNDS,
+               (double)elapsed / BENCH_ROUNDS,
+               (double)switches / BENCH_ROUNDS);
+    }
+    fflush(stdout);
+    exit(0);
+}
+
+int main(void)
+{
+    ping_semaphore = xSemaphoreCreateBinary();
+    pong_semaphore = xSemaphoreCreateBinary();
+    mutex = xSemaphoreCreateMutex();
+    events = xEventGroupCreate();
+    ping_queue = xQueueCreate(1, sizeof(void *));
+    pong_queue = xQueueCreate(1, sizeof(void *));
+    configASSERT(ping_semaphore && pong_semaphore && mutex && events
+                 && ping_queue && pong_queue);
+
+    xTaskCreate(driver_task, "Driver", configMINIMAL_STACK_SIZE, NULL,
+                configMAX_PRIORITIES - 2, &driver_handle);
+    configASSERT(driver_handle);
+
+    vTaskStartScheduler();
+    return 1;
+}
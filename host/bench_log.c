@@ -0,0 +1,108 @@
+/*
+ * Cost per logged event of the text screen path against the binary log.
+ *
+ * Replays BENCH_LOG_SECONDS consecutive clock seconds through the work
+ * print_task does for each of them: the text path formats the date and the
+ * time, draws both lines and flushes the differential renderer; the binary
+ * path encodes one BINLOG_TIME frame. The alarm event is measured the same
+ * way with the "ALARM!" line against a BINLOG_ALARM frame.
+ *
+ * Output is one JSON object per line:
+ *   {"path":"...","events":N,"ns_per_event":X,"uart_bytes_per_event":Y}
+ *
+ * The times are for the build machine; they rank the paths, they are not
+ * MCU cycle counts. The byte counts are exactly what the UART would send.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "binlog.h"
+#include "calendar.h"
+#include "clock.h"
+#include "vt100_render.h"
+#include "app_config.h"
+
+#ifndef BENCH_LOG_SECONDS
+#define BENCH_LOG_SECONDS 200000U
+#endif
+
+static char out[RENDER_OUT_MAX];
+static uint8_t frame[BINLOG_FRAME_MAX];
+static volatile size_t sink;    /**keeps the work from being optimised out*/
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static size_t text_time(uint32_t clock_seconds)
+{
+    static char text[RENDER_COLS];
+    static char date_text[RENDER_COLS];
+    clock_hms_t time;
+    calendar_date_t date;
+
+    clock_to_hms(clock_seconds, &time);
+    calendar_from_days(clock_seconds / SECONDS_PER_DAY, &date);
+    snprintf(date_text, sizeof(date_text), "%s %04d-%02d-%02d",
+             calendar_weekday_name(date.weekday), date.year, date.month,
+             date.day);
+    snprintf(text, sizeof(text), "%d : %d : %d hrs", time.hours,
+             time.minutes, time.seconds);
+    vt100_render_line(DATE_ROW, DATE_COL, date_text);
+    vt100_render_line(TIME_ROW, TIME_COL, text);
+    return vt100_render_flush(out, sizeof(out));
+}
+
+static size_t text_alarm(uint32_t clock_seconds)
+{
+    /**the line is blanked again so every event draws it*/
+    vt100_render_line(ALARM_ROW, ALARM_COL, (clock_seconds & 1) ? "ALARM!" : "");
+    return vt100_render_flush(out, sizeof(out));
+}
+
+static size_t binary_time(uint32_t clock_seconds)
+{
+    return binlog_encode(frame, BINLOG_TIME, clock_seconds * 1000U, &clock_seconds);
+}
+
+static size_t binary_alarm(uint32_t clock_seconds)
+{
+    return binlog_encode(frame, BINLOG_ALARM, clock_seconds * 1000U, &clock_seconds);
+}
+
+static void run(const char *name, size_t (*event)(uint32_t))
+{
+    uint32_t start = calendar_to_days(YEAR_INIT, MONTH_INIT, DAY_INIT) * SECONDS_PER_DAY;
+    uint64_t bytes = 0;
+    uint64_t begin;
+    uint64_t elapsed;
+    uint32_t i;
+
+    vt100_render_init(out, sizeof(out));
+    vt100_render_flush(out, sizeof(out));
+    begin = now_ns();
+    for (i = 0; i < BENCH_LOG_SECONDS; i++)
+    {
+        bytes += event(start + i);
+    }
+    elapsed = now_ns() - begin;
+    sink = (size_t)bytes;
+    printf("{\"path\":\"%s\",\"events\":%u,\"ns_per_event\":%.1f,"
+           "\"uart_bytes_per_event\":%.2f}\n", name, BENCH_LOG_SECONDS,
+           (double)elapsed / BENCH_LOG_SECONDS, (double)bytes / BENCH_LOG_SECONDS);
+}
+
+int main(void)
+{
+    run("text_time", text_time);
+    run("binlog_time", binary_time);
+    run("text_alarm", text_alarm);
+    run("binlog_alarm", binary_alarm);
+    return 0;
+}
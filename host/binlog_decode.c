@@ -0,0 +1,151 @@
+/*
+ * Host decoder of the APP_BINLOG=1 console stream.
+ *
+ *   ./build/binlog_decode [capture.bin] < /dev/ttyACM0
+ *
+ * Reads the UART bytes from the file or from stdin and writes one line per
+ * frame, prefixed with the target time in seconds since the log started:
+ *   [    12.000] Mon 2018-01-01 22 : 2 : 10 hrs
+ * The formats come from the BINLOG_MESSAGES table of binlog.h and the dates
+ * from calendar.c, the same sources the firmware is built from. Bytes that
+ * are not part of a frame, such as command replies, are copied unchanged.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "binlog.h"
+#include "calendar.h"
+#include "clock.h"
+
+#define BINLOG_FORMAT(id, args, format) format,
+static const char *const formats[BINLOG_MESSAGE_COUNT] = {
+    BINLOG_MESSAGES(BINLOG_FORMAT)
+};
+#undef BINLOG_FORMAT
+
+#define DEFAULT_TICK_HZ 1000U   /**until the BINLOG_START frame says otherwise*/
+
+static uint32_t tick_hz = DEFAULT_TICK_HZ;
+static uint64_t ticks;          /**tick count extended past 16 bits*/
+
+static uint32_t get_bytes(const uint8_t *in, uint8_t bytes)
+{
+    uint32_t value = 0;
+
+    while (bytes--)
+    {
+        value = (value << 8) | in[bytes];
+    }
+    return value;
+}
+
+/**%C: a clock second as shown on the screen*/
+static void print_clock(FILE *out, uint32_t clock_seconds)
+{
+    calendar_date_t date;
+    clock_hms_t time;
+
+    calendar_from_days(clock_seconds / SECONDS_PER_DAY, &date);
+    clock_to_hms(clock_seconds, &time);
+    fprintf(out, "%s %04u-%02u-%02u %u : %u : %u hrs",
+            calendar_weekday_name(date.weekday), date.year, date.month,
+            date.day, time.hours, time.minutes, time.seconds);
+}
+
+/**printf of a table format with unsigned arguments and %C*/
+static void print_message(FILE *out, const char *format, const uint32_t *args)
+{
+    char spec[8];
+    size_t len;
+
+    while (*format)
+    {
+        if ('%' != *format)
+        {
+            fputc(*format++, out);
+            continue;
+        }
+        len = strspn(format + 1, "0123456789");
+        if ((len + 3 > sizeof(spec)) || !format[len + 1])
+        {
+            fputs(format, out);     /**not a valid conversion, shown as is*/
+            return;
+        }
+        switch (format[len + 1])
+        {
+            case 'C':
+                print_clock(out, *args++);
+            break;
+            case '%':
+                fputc('%', out);
+            break;
+            default:
+                memcpy(spec, format, len + 2);
+                spec[len + 2] = '\0';
+                fprintf(out, spec, (unsigned)*args++);
+            break;
+        }
+        format += len + 2;
+    }
+}
+
+static void decode_frame(FILE *out, binlog_id_t id, const uint8_t *frame)
+{
+    uint32_t args[BINLOG_ARGS_MAX];
+    uint16_t low = (uint16_t)get_bytes(&frame[1], 2);
+    uint8_t i;
+
+    for (i = 0; i < binlog_arg_count[id]; i++)
+    {
+        args[i] = get_bytes(&frame[3 + 4 * i], 4);
+    }
+    if (BINLOG_START == id)
+    {
+        tick_hz = args[0] ? args[0] : DEFAULT_TICK_HZ;
+        ticks = low;        /**a new boot restarts the time line*/
+    }
+    /**frames come at least every second, far less than a 16 bit wrap*/
+    ticks += (uint16_t)(low - (uint16_t)ticks);
+    fprintf(out, "[%10.3f] ", (double)ticks / tick_hz);
+    print_message(out, formats[id], args);
+    fputs("\n", out);
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *in = stdin;
+    uint8_t frame[BINLOG_FRAME_MAX];
+    size_t len = 0;
+    size_t want = 0;
+    int c;
+
+    if ((argc > 1) && (NULL == (in = fopen(argv[1], "rb"))))
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    while (EOF != (c = fgetc(in)))
+    {
+        if (0 == len)
+        {
+            if ((BINLOG_SYNC != ((uint8_t)c & ~BINLOG_ID_MASK))
+                    || (((uint8_t)c & BINLOG_ID_MASK) >= BINLOG_MESSAGE_COUNT))
+            {
+                putchar(c);
+                fflush(stdout);
+                continue;
+            }
+            want = 3 + 4U * binlog_arg_count[c & BINLOG_ID_MASK];
+        }
+        frame[len++] = (uint8_t)c;
+        if (len == want)
+        {
+            decode_frame(stdout, (binlog_id_t)(frame[0] & BINLOG_ID_MASK), frame);
+            len = 0;
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for the MCUXpresso board.h.
+ */
+
+#ifndef _BOARD_H_
+#define _BOARD_H_
+
+#include "clock_config.h"
+#include "fsl_debug_console.h"
+
+/**the debug console is stdout on the host, nothing to initialise*/
+void BOARD_InitDebugConsole(void);
+
+#endif /* _BOARD_H_ */
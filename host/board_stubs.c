@@ -0,0 +1,197 @@
+/*
+ * Host stand-ins for the board initialisation done by MCUXpresso on target,
+ * plus the hooks the FreeRTOS POSIX port expects from the application.
+ */
+
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "pin_mux.h"
+#include "peripherals.h"
+#include "low_power.h"
+#include "clock.h"
+#include "console.h"
+#include "stats.h"
+#include "trace.h"
+#include "boot_time.h"
+#include "alarm_out.h"
+#include "alarm_out_host.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+uint32_t SystemCoreClock = 120000000U;
+
+void BOARD_InitBootPins(void)
+{
+}
+
+void BOARD_InitBootClocks(void)
+{
+}
+
+void BOARD_InitBootPeripherals(void)
+{
+}
+
+void BOARD_InitDebugConsole(void)
+{
+    setvbuf(stdout, NULL, _IOFBF, BUFSIZ);
+}
+
+void vAssertCalled(const char *file, unsigned long line)
+{
+    fprintf(stderr, "\nassert failed: %s:%lu\n", file, line);
+    abort();
+}
+
+void low_power_init(void)
+{
+}
+
+uint32_t boot_timer_port_read_us(void)
+{
+    static struct timespec start;
+    struct timespec now;
+
+    /**the process start stands for the reset*/
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if ((0 == start.tv_sec) && (0 == start.tv_nsec))
+    {
+        start = now;
+    }
+    return (uint32_t)((now.tv_sec - start.tv_sec) * 1000000L
+            + (now.tv_nsec - start.tv_nsec) / 1000L);
+}
+
+#ifndef HOST_SIM
+/**the host build has no tickless idle, every tick is a wake up*/
+uint32_t low_power_get_wakeups(void)
+{
+    return (uint32_t)xTaskGetTickCount();
+}
+#endif
+
+#if APP_CLOCK_RTC
+/**simulated RTC, it loses its time on every start like an RTC without VBAT*/
+static volatile uint32_t rtc_seconds;
+static volatile bool rtc_running;
+static TickType_t rtc_prescaler;
+
+bool clock_rtc_port_init(void)
+{
+    return false;
+}
+
+uint32_t clock_rtc_port_read(void)
+{
+    return rtc_seconds;
+}
+
+void clock_rtc_port_write(uint32_t seconds)
+{
+    taskENTER_CRITICAL();
+    rtc_seconds = seconds;
+    rtc_prescaler = 0;
+    rtc_running = true;
+    taskEXIT_CRITICAL();
+}
+
+#endif
+
+#if configUSE_TICK_HOOK
+/**countdown compare of hrtimer_host.c*/
+void hrtimer_host_tick(void);
+
+void vApplicationTickHook(void)
+{
+#if APP_CLOCK_RTC
+    /**the RTC seconds interrupt, every CLOCK_PERIOD_TICKS host ticks*/
+    if (rtc_running && (++rtc_prescaler >= CLOCK_PERIOD_TICKS))
+    {
+        rtc_prescaler = 0;
+        rtc_seconds++;
+        clock_rtc_second_from_isr(NULL);
+    }
+#endif
+#if APP_HRTIMER
+    hrtimer_host_tick();
+#endif
+#if APP_ALARM_OUT
+    alarm_out_host_tick();
+#endif
+}
+#endif
+
+#ifndef HOST_SIM
+/**the simulation harness owns the console and the trace instead*/
+void console_port_init(void)
+{
+}
+
+void console_port_start(void)
+{
+    BOARD_InitBootPeripherals();
+    fputs("\033[2J", stdout); /**clear screen VT100 command*/
+}
+
+void console_port_write(const char *data, size_t len)
+{
+    fwrite(data, 1, len, stdout);
+    fflush(stdout);
+}
+
+char console_port_read(void)
+{
+    struct pollfd fd = { .fd = STDIN_FILENO, .events = POLLIN };
+    char byte;
+
+    /**a blocking read would stall the whole simulated kernel, so poll*/
+    for (;;)
+    {
+        if ((poll(&fd, 1, 0) > 0) && (1 == read(STDIN_FILENO, &byte, 1)))
+        {
+            return byte;
+        }
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+}
+
+#endif /* HOST_SIM */
+
+#if APP_STATS
+void stats_timer_init(void)
+{
+}
+
+unsigned long stats_timer_read(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)(now.tv_sec * STATS_RUNTIME_HZ
+            + now.tv_nsec / (1000000000L / STATS_RUNTIME_HZ));
+}
+#endif
+
+#if APP_TRACE && !defined(HOST_SIM)
+void trace_timer_init(void)
+{
+}
+
+uint32_t trace_timer_read(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000L + now.tv_nsec / 1000L);
+}
+
+uint32_t trace_timer_ticks_per_us(void)
+{
+    return 1;
+}
+#endif
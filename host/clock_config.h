@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for the MCUXpresso clock_config.h.
+ */
+
+#ifndef _CLOCK_CONFIG_H_
+#define _CLOCK_CONFIG_H_
+
+#include <stdint.h>
+
+extern uint32_t SystemCoreClock;
+
+void BOARD_InitBootClocks(void);
+
+#endif /* _CLOCK_CONFIG_H_ */
@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for the MCUXpresso fsl_debug_console.h.
+ * PRINTF goes straight to stdout and is flushed so the VT100 output
+ * shows up as soon as it is produced.
+ */
+
+#ifndef _FSL_DEBUGCONSOLE_H_
+#define _FSL_DEBUGCONSOLE_H_
+
+#include <stdio.h>
+
+#define PRINTF(...) do { printf(__VA_ARGS__); fflush(stdout); } while (0)
+
+#endif /* _FSL_DEBUGCONSOLE_H_ */
@@ -0,0 +1,98 @@
+/*
+ * Host stand-in for the FTM0 counter of hrtimer_ftm.c.
+ *
+ * The counter runs at 1 MHz from CLOCK_MONOTONIC, or from the kernel tick
+ * count in the virtual time simulation. The compare interrupt is the tick
+ * hook checking the armed deadline, so a countdown expires on the first
+ * host tick after its deadline. The simulation asks hrtimer_host_idle_ticks
+ * before it skips idle ticks, so it never jumps over that tick.
+ */
+
+#include <time.h>
+
+#include "hrtimer.h"
+#include "task.h"
+
+#if APP_HRTIMER
+
+#define HOST_COUNTER_HZ 1000000U
+#define COUNTS_PER_TICK (HOST_COUNTER_HZ / configTICK_RATE_HZ)
+
+static volatile uint64_t deadline;
+static volatile bool armed;
+#ifndef HOST_SIM
+static struct timespec origin;
+#endif
+
+void hrtimer_port_init(void)
+{
+#ifndef HOST_SIM
+    clock_gettime(CLOCK_MONOTONIC, &origin);
+#endif
+}
+
+uint32_t hrtimer_port_hz(void)
+{
+    return HOST_COUNTER_HZ;
+}
+
+uint64_t hrtimer_port_now(void)
+{
+#ifdef HOST_SIM
+    /**virtual time, it jumps with the ticks the simulation skips*/
+    return (uint64_t)xTaskGetTickCountFromISR() * COUNTS_PER_TICK;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - origin.tv_sec) * HOST_COUNTER_HZ
+            + (uint64_t)(now.tv_nsec - origin.tv_nsec + 1000000000L) / 1000U
+            - HOST_COUNTER_HZ;
+#endif
+}
+
+void hrtimer_port_arm(uint64_t at)
+{
+    deadline = at;
+    armed = true;
+}
+
+void hrtimer_port_disarm(void)
+{
+    armed = false;
+}
+
+/**called from the tick hook of board_stubs.c*/
+void hrtimer_host_tick(void)
+{
+    if (armed && (hrtimer_port_now() >= deadline))
+    {
+        armed = false;
+        hrtimer_expired_from_isr(NULL);
+    }
+}
+
+#ifdef HOST_SIM
+/**
+ * Idle ticks the simulation may skip: all of them, or up to the one before
+ * the tick that sees the armed deadline, which then runs the tick hook.
+ */
+TickType_t hrtimer_host_idle_ticks(TickType_t idle_ticks)
+{
+    const uint64_t now = xTaskGetTickCount();
+    uint64_t seen;
+
+    if (!armed)
+    {
+        return idle_ticks;
+    }
+    seen = (deadline + COUNTS_PER_TICK - 1U) / COUNTS_PER_TICK;
+    if (seen <= now + 1U)
+    {
+        return 0;
+    }
+    return (seen - now - 1U < idle_ticks) ? (TickType_t)(seen - now - 1U) : idle_ticks;
+}
+#endif
+
+#endif /* APP_HRTIMER */
@@ -0,0 +1,10 @@
+/*
+ * Host stand-in for the MCUXpresso peripherals.h.
+ */
+
+#ifndef _PERIPHERALS_H_
+#define _PERIPHERALS_H_
+
+void BOARD_InitBootPeripherals(void);
+
+#endif /* _PERIPHERALS_H_ */
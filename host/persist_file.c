@@ -0,0 +1,93 @@
+/*
+ * Host stand-in for the persistence flash. The log area is an image in
+ * memory that behaves like NOR flash (erase sets every bit, programming
+ * only clears bits) and is mirrored into the file named by RELOJ_FLASH,
+ * reloj_flash.bin by default, so a restarted host build resumes from it.
+ * The simulation build keeps the image in memory only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "persist.h"
+
+#define IMAGE_SIZE (PERSIST_SECTORS * PERSIST_SECTOR_SIZE)
+
+static uint8_t image[IMAGE_SIZE];
+static FILE *image_file;
+
+static void image_sync(uint32_t offset, uint32_t len)
+{
+    if (NULL != image_file)
+    {
+        fseek(image_file, (long)offset, SEEK_SET);
+        fwrite(&image[offset], 1, len, image_file);
+        fflush(image_file);
+    }
+}
+
+#ifndef HOST_SIM
+static void image_open(void)
+{
+    const char *path = getenv("RELOJ_FLASH");
+    size_t loaded;
+
+    if (NULL == path)
+    {
+        path = "reloj_flash.bin";
+    }
+    image_file = fopen(path, "r+b");
+    if (NULL == image_file)
+    {
+        image_file = fopen(path, "w+b");
+    }
+    if (NULL != image_file)
+    {
+        /**a new or short file is padded with erased flash*/
+        loaded = fread(image, 1, sizeof(image), image_file);
+        image_sync(loaded, sizeof(image) - loaded);
+    }
+}
+#endif
+
+void persist_port_init(void)
+{
+    memset(image, 0xFF, sizeof(image));
+#ifndef HOST_SIM
+    image_open();
+#endif
+}
+
+void persist_port_read(uint32_t offset, void *data, uint32_t len)
+{
+    memcpy(data, &image[offset], len);
+}
+
+bool persist_port_program(uint32_t offset, const void *data, uint32_t len)
+{
+    const uint8_t *bytes = data;
+    uint32_t i;
+
+    if ((offset + len > IMAGE_SIZE) || (offset % 8) || (len % 8))
+    {
+        return false;
+    }
+    for (i = 0; i < len; i++)
+    {
+        image[offset + i] &= bytes[i];
+    }
+    image_sync(offset, len);
+    return true;
+}
+
+bool persist_port_erase(uint32_t offset)
+{
+    if ((offset % PERSIST_SECTOR_SIZE) || (offset >= IMAGE_SIZE))
+    {
+        return false;
+    }
+    memset(&image[offset], 0xFF, PERSIST_SECTOR_SIZE);
+    image_sync(offset, PERSIST_SECTOR_SIZE);
+    return true;
+}
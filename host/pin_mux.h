@@ -0,0 +1,10 @@
+/*
+ * Host stand-in for the MCUXpresso pin_mux.h.
+ */
+
+#ifndef _PIN_MUX_H_
+#define _PIN_MUX_H_
+
+void BOARD_InitBootPins(void);
+
+#endif /* _PIN_MUX_H_ */
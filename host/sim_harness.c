@@ -0,0 +1,1050 @@
+/*
+ * Virtual time simulation harness for Reloj_Alarma.
+ *
+ * The application runs unmodified on the POSIX port, built with tracing on.
+ * Whenever every task is blocked the idle task's tickless hook steps the
+ * kernel tick straight to the next wake up (sim_fast_forward), so simulated
+ * time costs only the work the tasks actually do. The harness owns the
+ * console: a small VT100 model keeps the screen the firmware would draw, and
+ * the application tracepoints are checked against a reference clock derived
+ * from the tick count:
+ *
+ *   - clock_task wakes exactly on each second boundary, every second once;
+ *   - the time drawn on the screen is the reference time for that second,
+ *     and the date drawn matches the C library's calendar;
+ *   - every shown time zone row matches timezone.c and calendar.c for that
+ *     second, and at each hour boundary the zone's offset matches the C
+ *     library's POSIX TZ rule, so the EU and US daylight saving changes of
+ *     the run are checked against an independent reference;
+ *   - the alarm fires once per day, on its second, and "ALARM!" is drawn;
+ *   - alarm_task runs for the alarm within the tick of the clock wake up,
+ *     the worst wake up to dispatch wall time is reported;
+ *   - the alarm output starts playing in that tick, and the waveform
+ *     recorded by alarm_out_host.c goes silent on its own once
+ *     ALARM_OUT_TIMEOUT_S have gone by, taking the message with it;
+ *   - text of console_put_line never lands in, or scrolls, the renderer rows;
+ *   - the skipped idle periods leave fewer than one CPU wake up in
+ *     SIM_WAKEUP_RATIO plain ticks, the count low_power_get_wakeups gives
+ *     the stats command;
+ *   - the commands of key_script, typed at boot, each get their reply whole,
+ *     the longer ones than CONSOLE_LINE_MAX too;
+ *   - a burst of console writes several times the ring is handled by the
+ *     CONSOLE_POLICY the sim was built with: the records that come out are
+ *     whole (but for the cut front of the first under drop oldest), in
+ *     order, the oldest or the newest as the policy says, and the dropped
+ *     counter accounts for the rest;
+ *   - while print_task is held back for SIM_BURST_SECONDS the time posts
+ *     coalesce in its mailbox, it wakes once and draws the newest second;
+ *   - the countdowns of countdown_plan are reported in deadline order, each
+ *     on the first tick its deadline is seen, and the cancelled ones, in
+ *     the middle of the list and at its head, never are.
+ *
+ * Build with "make sim" and run ./build/sim/reloj_sim [days]; the exit code
+ * is the number of failed checks (capped at 255).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "app_config.h"
+#include "clock.h"
+#include "calendar.h"
+#include "console.h"
+#include "trace.h"
+#include "timezone.h"
+#include "vt100_render.h"
+#include "alarm_out.h"
+#include "alarm_out_host.h"
+#include "hrtimer.h"
+#include "low_power.h"
+
+#define UNIX_SECONDS_AT_EPOCH 946684800L  /**2000-01-01 in Unix time*/
+#define SIM_DEFAULT_DAYS 365    /**simulated horizon when none is given*/
+#define SIM_MAX_REPORTS 20      /**failures printed before going quiet*/
+#define SCREEN_ROWS 24   /**rows of the modelled terminal*/
+#define SCREEN_COLS RENDER_COLS
+#define SIM_STEP_MAX_MS 1000    /**longest step of a pattern*/
+#define SIM_FLOOD_AT 5          /**seconds from the start to the console flood*/
+#define SIM_FLOOD_RECORDS 128   /**records written in the flood*/
+#define SIM_FLOOD_RECORD 12     /**bytes per record, "\001flood nnnn\002"*/
+#define SIM_BURST_SECONDS 3     /**seconds print_task is held back*/
+#define SIM_COUNTDOWN_AT 10     /**seconds from the start to the countdowns*/
+#define SIM_COUNTDOWN_SECONDS 3 /**seconds until every countdown is over*/
+#define SIM_US_PER_TICK (1000000U / configTICK_RATE_HZ)
+#define SIM_WAKEUP_RATIO 20     /**plain ticks per wake up at least*/
+
+static uint32_t sim_days = SIM_DEFAULT_DAYS;
+static uint32_t start_second;
+static uint32_t last_wake;
+static uint32_t alarm_count;
+static uint32_t alarm_day = UINT32_MAX;
+static uint32_t failures;
+static uint32_t fast_forwards;
+static uint32_t skipped_ticks;      /**ticks stepped over, modulo the tick type*/
+static struct timespec wall_start;
+static struct timespec wake_wall;   /**wall time of the last clock wake up*/
+static TickType_t wake_tick;        /**tick of the last clock wake up*/
+static double dispatch_max_us;      /**worst wake up to alarm_task, wall time*/
+static uint64_t ring_start_ms;      /**waveform time of the last alarm*/
+static uint32_t zone_summer;        /**bit per zone in DST at the last check*/
+static uint32_t zone_checked;       /**bit per zone checked at least once*/
+static uint32_t zone_changes[32];   /**DST changes seen per zone*/
+static TaskHandle_t print_handle;   /**print_task, seen at its first wake up*/
+static uint32_t burst_second;       /**clock second print_task is released*/
+static uint32_t burst_wakes;        /**print_task wake ups since it was held*/
+static uint32_t flood_accepted;     /**records console_write took*/
+static uint32_t flood_remaining;    /**flood bytes still to come out*/
+static uint32_t flood_first = UINT32_MAX; /**first whole record out*/
+static uint32_t flood_last;         /**last whole record out*/
+static uint32_t flood_out;          /**whole records out*/
+static uint32_t flood_cut;          /**bytes of a record cut at the front*/
+static char flood_record[SIM_FLOOD_RECORD];
+static size_t flood_len;
+static int flood_done;
+
+#if APP_HRTIMER
+/**
+ * Countdowns started together, off the tick on purpose. A cancel of 1 is
+ * done at once, in the middle of the list, 2 at the next second, when the
+ * countdown is the head of the list. The last two expire in the same tick,
+ * the later id first.
+ */
+static const struct {
+    uint32_t us;
+    uint8_t cancel;
+} countdown_plan[] = {
+    { 2500000U, 0 },
+    { 700001U, 0 },
+    { 1300000U, 2 },
+    { 1799999U, 0 },
+    { 900000U, 1 },
+    { 1600003U, 0 },
+    { 1600001U, 0 },
+};
+
+#define SIM_COUNTDOWNS (sizeof(countdown_plan) / sizeof(countdown_plan[0]))
+
+static uint8_t countdown_id[SIM_COUNTDOWNS];
+static TickType_t countdown_due[SIM_COUNTDOWNS]; /**tick that sees the deadline*/
+static uint32_t countdown_last_us;  /**length of the last one reported*/
+static uint32_t countdown_fired;    /**bit per plan entry reported*/
+static int countdown_checked;
+#endif
+
+/**
+ * Typed at boot, one line each, with the first line of the reply. Between
+ * them they give every fixed reply of command.c that leaves the state as
+ * it is; the countdown started is cancelled again, an id past the table
+ * must not cancel it.
+ */
+static const struct {
+    const char *keys;
+    const char *reply;
+} key_script[] = {
+    { "set-time 25:00:00", "usage: set-time HH:MM:SS" },
+    { "set-date 2000-13-01", "usage: set-date YYYY-MM-DD" },
+    { "set-alarm 7", "usage: set-alarm HH:MM:SS [YYYY-MM-DD|daily|weekdays|"
+            "weekends|mon,tue,...]" },
+    { "del-alarm 99", "no such alarm" },
+    { "zones XYZ", "usage: zones [none|all|NAME,NAME,...]" },
+#if APP_HRTIMER
+    { "stopwatch lap", "usage: stopwatch [start|stop|reset]" },
+    { "countdown soon", "usage: countdown [MS|cancel ID]" },
+    { "countdown 60000", "countdown 0 started" },
+    { "countdown cancel 256", "no such countdown" },
+    { "countdown cancel 0", "ok" },
+#endif
+#if APP_ALARM_OUT
+    { "ring x", "usage: ring [PATTERN]" },
+#endif
+    { "set-time", "wrong number of arguments" },
+    { "list a b c", "too many arguments" },
+    { "nothing", "unknown command" },
+    { "set-alarm 07:00:00 weekdays and then some more words", "line too long" },
+};
+
+#define SIM_KEY_LINES (sizeof(key_script) / sizeof(key_script[0]))
+#define SIM_TEXT_LINE_MAX 128   /**longest reply line the harness compares*/
+
+static size_t key_line;     /**script line being typed*/
+static size_t key_pos;
+static size_t reply_line;   /**script line whose reply comes next*/
+
+/**text of console_put_line since the last line break*/
+static char text_line[SIM_TEXT_LINE_MAX + 1];
+static size_t text_len;
+
+#if SIM_FLOOD_RECORDS * SIM_FLOOD_RECORD <= 2 * CONSOLE_RING_SIZE
+#error "the console flood must overflow the ring"
+#endif
+
+/**
+ * POSIX TZ rules of the default APP_TIMEZONES, an independent reference
+ * for timezone.c. A zone without one is only checked against timezone.c.
+ */
+static const struct {
+    const char *name;
+    const char *tz;
+} zone_rules[] = {
+    { "UTC", "UTC0" },
+    { "NYC", "EST5EDT,M3.2.0,M11.1.0" },
+    { "MAD", "CET-1CEST,M3.5.0,M10.5.0/3" },
+    { "GDL", "CST6" },
+};
+
+#if SCREEN_ROWS < TEXT_ROW
+#error "the modelled terminal must hold the command output"
+#endif
+
+static char screen[SCREEN_ROWS][SCREEN_COLS];
+static int cursor_row;
+static int cursor_col;
+static int saved_row;       /**cursor saved by ESC 7*/
+static int saved_col;
+static int scroll_top;      /**scrolling region, 0-based rows*/
+static int scroll_bottom = SCREEN_ROWS - 1;
+static int in_text;         /**between the ESC 8 and ESC 7 of console_put_line*/
+
+static void fail(const char *what, uint32_t second)
+{
+    clock_hms_t hms;
+
+    failures++;
+    if (failures <= SIM_MAX_REPORTS)
+    {
+        clock_to_hms(second, &hms);
+        printf("FAIL day %lu %02u:%02u:%02u: %s\n",
+               (unsigned long)((second - start_second) / SECONDS_PER_DAY), hms.hours,
+               hms.minutes, hms.seconds, what);
+    }
+}
+
+/**reference clock second from the kernel tick alone*/
+static uint32_t reference_second(void)
+{
+    return start_second + xTaskGetTickCount() / CLOCK_PERIOD_TICKS;
+}
+
+static int screen_matches(int row, int col, const char *text)
+{
+    size_t len = strlen(text);
+    int c;
+
+    if (0 != memcmp(&screen[row - 1][col - 1], text, len))
+    {
+        return 0;
+    }
+    for (c = col - 1 + (int)len; c < SCREEN_COLS; c++)
+    {
+        if (' ' != screen[row - 1][c])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * The last alarm went silent by itself once its timeout was reached. The
+ * last change is the stop, or the silent step the stop came in.
+ */
+static void check_auto_stop(uint32_t second)
+{
+    const uint64_t stop_ms = ring_start_ms + ALARM_OUT_TIMEOUT_S * 1000U;
+    const alarm_out_event_t *last = alarm_out_host_event(alarm_out_host_events() - 1U);
+
+    if ((ALARM_OUT_IDLE != alarm_out_state()) || (NULL == last) || last->tone_hz
+            || last->led || (last->ms + SIM_STEP_MAX_MS <= stop_ms)
+            || (last->ms >= stop_ms + SIM_STEP_MAX_MS))
+    {
+        fail("alarm output did not stop after its timeout", second);
+    }
+}
+
+/**POSIX TZ rule of a zone, or NULL*/
+static const char *zone_rule(uint8_t zone)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(zone_rules) / sizeof(zone_rules[0]); i++)
+    {
+        if (0 == strcmp(zone_rules[i].name, timezone_name(zone)))
+        {
+            return zone_rules[i].tz;
+        }
+    }
+    return NULL;
+}
+
+/**the C library's offset of a zone at a clock second agrees with timezone.c*/
+static void check_zone_rule(uint8_t zone, uint32_t second, uint32_t local)
+{
+    time_t unix_time = (time_t)(UNIX_SECONDS_AT_EPOCH + second);
+    const char *rule = zone_rule(zone);
+    struct tm tm;
+
+    if (NULL == rule)
+    {
+        return;
+    }
+    setenv("TZ", rule, 1);
+    tzset();
+    localtime_r(&unix_time, &tm);
+    if ((long)local - (long)second != tm.tm_gmtoff)
+    {
+        fail("zone offset differs from the C library", second);
+    }
+}
+
+/**
+ * A year long run crosses both changes of every daylight saving rule, a
+ * shown zone with a rule must have changed on the screen at least twice.
+ */
+static void check_zone_changes(void)
+{
+    const char *rule;
+    uint8_t zone;
+
+    for (zone = 0; zone < timezone_count(); zone++)
+    {
+        rule = zone_rule(zone);
+        printf("zone %s: %lu daylight saving changes shown\n", timezone_name(zone),
+               (unsigned long)zone_changes[zone]);
+        if ((sim_days >= 365) && (zone_checked & (1UL << zone)) && (NULL != rule)
+                && (NULL != strchr(rule, ',')) && (zone_changes[zone] < 2))
+        {
+            fail("zone missed a daylight saving change", reference_second());
+        }
+    }
+}
+
+/**
+ * The zone rows show the shown zones in table order, as timezone.c and
+ * calendar.c give them for the second, and the rows left over are blank.
+ */
+static void check_zones(uint32_t second)
+{
+    char expected[RENDER_COLS];
+    calendar_date_t date;
+    clock_hms_t hms;
+    uint32_t local;
+    uint32_t bit;
+    bool summer;
+    uint8_t zone;
+    int row = ZONE_ROW;
+
+    for (zone = 0; (zone < timezone_count()) && (row <= RENDER_ROWS); zone++)
+    {
+        bit = 1UL << zone;
+        if (!(timezone_shown() & bit))
+        {
+            continue;
+        }
+        local = timezone_local(zone, second, &summer);
+        calendar_from_days(local / SECONDS_PER_DAY, &date);
+        clock_to_hms(local, &hms);
+        snprintf(expected, sizeof(expected), "%-4s %s %04d-%02d-%02d %02d:%02d:%02d%s",
+                 timezone_name(zone), calendar_weekday_name(date.weekday),
+                 date.year, date.month, date.day, hms.hours, hms.minutes,
+                 hms.seconds, summer ? " DST" : "");
+        if (!screen_matches(row++, ZONE_COL, expected))
+        {
+            fail("displayed zone differs from timezone.c", second);
+        }
+        if ((zone_checked & bit) && (summer != !!(zone_summer & bit)))
+        {
+            zone_changes[zone]++;
+        }
+        zone_checked |= bit;
+        zone_summer = summer ? (zone_summer | bit) : (zone_summer & ~bit);
+        /**the changes of both rules fall on a UTC hour boundary*/
+        if ((0 == second % 3600U) || (3599 == second % 3600U))
+        {
+            check_zone_rule(zone, second, local);
+        }
+    }
+    for (; row <= RENDER_ROWS; row++)
+    {
+        if (!screen_matches(row, ZONE_COL, ""))
+        {
+            fail("zone row not blank", second);
+        }
+    }
+}
+
+static void report_and_exit(void)
+{
+    const uint32_t alarm_second = HMS_TO_SECONDS(HOURS_ALARM, MINUTES_ALARM,
+                                                 SECONDS_ALARM);
+    uint32_t expected_alarms = sim_days;
+    struct timespec wall_end;
+    double wall;
+    double simulated = (double)(reference_second() - start_second);
+    const uint32_t wakeups = low_power_get_wakeups();
+    const double plain_ticks = (double)(last_wake - start_second) * configTICK_RATE_HZ;
+
+    /**on the first day the alarm only rings if it is not already past*/
+    if (alarm_second < start_second % SECONDS_PER_DAY)
+    {
+        expected_alarms--;
+    }
+    if (alarm_count != expected_alarms)
+    {
+        fail("wrong number of alarms over the run", reference_second());
+    }
+    if (alarm_count && (ALARM_OUT_PLAYING == alarm_out_state()))
+    {
+        if (!screen_matches(ALARM_ROW, ALARM_COL, "ALARM!"))
+        {
+            fail("alarm message not on screen", reference_second());
+        }
+    } else if (alarm_count)
+    {
+        check_auto_stop(reference_second());
+        if (!screen_matches(ALARM_ROW, ALARM_COL, ""))
+        {
+            fail("alarm message left on screen", reference_second());
+        }
+    }
+
+    check_zone_changes();
+    if ((double)wakeups * SIM_WAKEUP_RATIO > plain_ticks)
+    {
+        fail("tickless idle left too many wake ups", reference_second());
+    }
+    if (SIM_KEY_LINES != reply_line)
+    {
+        fail("command reply missing", reference_second());
+    }
+    if (!flood_done)
+    {
+        fail("console flood did not come out", reference_second());
+    }
+#if APP_HRTIMER
+    if (!countdown_checked)
+    {
+        fail("countdowns were not checked", reference_second());
+    }
+#endif
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    wall = (double)(wall_end.tv_sec - wall_start.tv_sec)
+            + (double)(wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+    printf("simulated %.0f s (%lu days) in %.2f s wall: %.0f sim-s/wall-s\n",
+           simulated, (unsigned long)sim_days, wall,
+           wall > 0 ? simulated / wall : 0.0);
+    printf("wakeups %lu: %.0f per hour, %.0f per hour with a plain tick\n",
+           (unsigned long)wakeups,
+           simulated > 0 ? (double)wakeups * 3600.0 / simulated : 0.0,
+           (double)configTICK_RATE_HZ * 3600.0);
+    printf("alarm dispatch: max %.1f us wall from the clock wake up\n",
+           dispatch_max_us);
+    printf("console flood: %lu of %lu records out, policy drop %s\n",
+           (unsigned long)flood_out, (unsigned long)SIM_FLOOD_RECORDS,
+           (CONSOLE_DROP_NEWEST == CONSOLE_POLICY) ? "newest" : "oldest");
+    printf("alarms %lu, fast-forwards %lu, failures %lu\n",
+           (unsigned long)alarm_count, (unsigned long)fast_forwards,
+           (unsigned long)failures);
+    fflush(stdout);
+    exit(failures > 255 ? 255 : (int)failures);
+}
+
+/**
+ * Writes the flood from clock_task, which outruns console_task, so the
+ * ring overflows. The ring is empty: the console drains before the
+ * kernel goes idle and every second starts from idle. What should come
+ * out follows from the policy alone, the stats have to agree with it.
+ */
+static void flood_start(uint32_t second)
+{
+    console_stats_t before;
+    console_stats_t after;
+    char record[SIM_FLOOD_RECORD + 1];
+    uint32_t expected_dropped;
+    uint32_t i;
+
+    console_get_stats(&before);
+    for (i = 0; i < SIM_FLOOD_RECORDS; i++)
+    {
+        snprintf(record, sizeof(record), "\001flood %04lu\002", (unsigned long)i);
+        if (SIM_FLOOD_RECORD == console_write(record, SIM_FLOOD_RECORD))
+        {
+            flood_accepted++;
+        }
+    }
+    console_get_stats(&after);
+    if (CONSOLE_DROP_NEWEST == CONSOLE_POLICY)
+    {
+        flood_remaining = flood_accepted * SIM_FLOOD_RECORD;
+        expected_dropped = (SIM_FLOOD_RECORDS - flood_accepted) * SIM_FLOOD_RECORD;
+        if (flood_accepted != CONSOLE_RING_SIZE / SIM_FLOOD_RECORD)
+        {
+            fail("drop newest took other than the records that fit", second);
+        }
+    } else
+    {
+        flood_remaining = CONSOLE_RING_SIZE;
+        expected_dropped = SIM_FLOOD_RECORDS * SIM_FLOOD_RECORD - CONSOLE_RING_SIZE;
+        if (flood_accepted != SIM_FLOOD_RECORDS)
+        {
+            fail("drop oldest refused a write", second);
+        }
+    }
+    if ((after.dropped - before.dropped != expected_dropped)
+            || (after.written - before.written != flood_accepted * SIM_FLOOD_RECORD))
+    {
+        fail("console counters disagree with the flood", second);
+    }
+}
+
+/**
+ * Checks one flood byte on its way out. Records come out whole and in
+ * sequence; drop oldest may cut the front of the first one, drop newest
+ * never cuts. The last byte checks the ends against the policy.
+ */
+static void flood_put(char c)
+{
+    const uint32_t second = reference_second();
+    uint32_t seq;
+
+    if ((0 == flood_len) && ('\001' != c))
+    {
+        flood_cut++;
+        if ((CONSOLE_DROP_NEWEST == CONSOLE_POLICY) || (UINT32_MAX != flood_first)
+                || (flood_cut >= SIM_FLOOD_RECORD))
+        {
+            fail("console flood record broken", second);
+        }
+    } else
+    {
+        flood_record[flood_len++] = c;
+    }
+    if (SIM_FLOOD_RECORD == flood_len)
+    {
+        flood_len = 0;
+        seq = (uint32_t)strtoul(&flood_record[7], NULL, 10);
+        if (('\002' != flood_record[SIM_FLOOD_RECORD - 1])
+                || (0 != memcmp(flood_record, "\001flood ", 7)))
+        {
+            fail("console flood record broken", second);
+        } else if ((UINT32_MAX != flood_first) && (seq != flood_last + 1))
+        {
+            fail("console flood records out of order", second);
+        }
+        if (UINT32_MAX == flood_first)
+        {
+            flood_first = seq;
+        }
+        flood_last = seq;
+        flood_out++;
+    }
+    if (0 != --flood_remaining)
+    {
+        return;
+    }
+    flood_done = 1;
+    if (0 != flood_len)
+    {
+        fail("console flood ended inside a record", second);
+    }
+    if ((CONSOLE_DROP_NEWEST == CONSOLE_POLICY)
+            ? ((0 != flood_first) || (flood_out != flood_accepted))
+            : ((SIM_FLOOD_RECORDS - 1 != flood_last)
+                    || (flood_out != CONSOLE_RING_SIZE / SIM_FLOOD_RECORD)))
+    {
+        fail("console flood kept the wrong records for its policy", second);
+    }
+}
+
+#if APP_HRTIMER
+/**cancels the countdowns of the plan marked with a pass*/
+static void countdowns_cancel(uint8_t pass, uint32_t second)
+{
+    size_t i;
+
+    for (i = 0; i < SIM_COUNTDOWNS; i++)
+    {
+        if ((pass == countdown_plan[i].cancel)
+                && !hrtimer_countdown_cancel(countdown_id[i]))
+        {
+            fail("running countdown not cancelled", second);
+        }
+    }
+}
+
+/**starts the countdowns of the plan, from clock_task*/
+static void countdowns_start(uint32_t second)
+{
+    const TickType_t now = xTaskGetTickCount();
+    size_t i;
+
+    for (i = 0; i < SIM_COUNTDOWNS; i++)
+    {
+        countdown_id[i] = hrtimer_countdown_start(countdown_plan[i].us);
+        countdown_due[i] = now + (countdown_plan[i].us + SIM_US_PER_TICK - 1U)
+                / SIM_US_PER_TICK;
+        if (HRTIMER_NONE == countdown_id[i])
+        {
+            fail("countdown not started", second);
+        }
+    }
+    countdowns_cancel(1, second);
+}
+
+/**every countdown of the plan not cancelled has been reported*/
+static void countdowns_check(uint32_t second)
+{
+    uint32_t expected = 0;
+    size_t i;
+
+    for (i = 0; i < SIM_COUNTDOWNS; i++)
+    {
+        if (0 == countdown_plan[i].cancel)
+        {
+            expected |= 1UL << i;
+        }
+    }
+    if (countdown_fired != expected)
+    {
+        fail("countdown not reported", second);
+    }
+    countdown_checked = 1;
+}
+
+/**a "countdown N done" line came out, on the tick of its deadline*/
+static void countdown_done(unsigned id)
+{
+    const uint32_t second = reference_second();
+    size_t i;
+
+    for (i = 0; (i < SIM_COUNTDOWNS) && (countdown_id[i] != id); i++)
+    {
+    }
+    if ((i == SIM_COUNTDOWNS) || countdown_plan[i].cancel
+            || (countdown_fired & (1UL << i)))
+    {
+        fail("cancelled or unknown countdown reported", second);
+        return;
+    }
+    if (xTaskGetTickCount() != countdown_due[i])
+    {
+        fail("countdown reported off the tick of its deadline", second);
+    }
+    /**started together, so the deadline order is the order of their lengths*/
+    if (countdown_plan[i].us < countdown_last_us)
+    {
+        fail("countdowns reported out of deadline order", second);
+    }
+    countdown_last_us = countdown_plan[i].us;
+    countdown_fired |= 1UL << i;
+}
+
+/**idle ticks the host counter lets the simulation skip*/
+TickType_t hrtimer_host_idle_ticks(TickType_t idle_ticks);
+#endif
+
+/**a line of console_put_line text is complete*/
+static void text_line_done(void)
+{
+#if APP_HRTIMER
+    unsigned id;
+    int end = 0;
+#endif
+
+    text_line[text_len] = '\0';
+    if (0 == text_len)
+    {
+        return;
+    }
+    text_len = 0;
+#if APP_HRTIMER
+    if ((1 == sscanf(text_line, "countdown %u done%n", &id, &end))
+            && ((size_t)end == strlen(text_line)))
+    {
+        countdown_done(id);
+        return;
+    }
+#endif
+    if (reply_line < SIM_KEY_LINES)
+    {
+        if (0 != strcmp(text_line, key_script[reply_line].reply))
+        {
+            fail("command reply cut or out of order", reference_second());
+        }
+        reply_line++;
+    }
+}
+
+void sim_fast_forward(TickType_t idle_ticks)
+{
+#if APP_HRTIMER
+    /**a countdown deadline is no kernel timeout, its tick must not be skipped*/
+    idle_ticks = hrtimer_host_idle_ticks(idle_ticks);
+    if (0 == idle_ticks)
+    {
+        return;
+    }
+#endif
+    /**nothing is runnable: jump to the next wake up instead of waiting for it*/
+    vTaskStepTick(idle_ticks);
+    skipped_ticks += idle_ticks;
+    fast_forwards++;
+}
+
+/**
+ * The simulation's tickless idle: every tick the kernel ran, plus the wake
+ * up ending each skip, as the LPTMR sleep of low_power.c counts them.
+ */
+uint32_t low_power_get_wakeups(void)
+{
+    return (uint32_t)(xTaskGetTickCount() - skipped_ticks) + fast_forwards;
+}
+
+void trace_point(trace_event_t event, uint32_t arg)
+{
+    static char expected[SCREEN_COLS];
+    const uint32_t alarm_second = HMS_TO_SECONDS(HOURS_ALARM, MINUTES_ALARM,
+                                                 SECONDS_ALARM);
+    clock_hms_t hms;
+    uint32_t day = arg / SECONDS_PER_DAY - start_second / SECONDS_PER_DAY;
+    time_t unix_time = (time_t)(UNIX_SECONDS_AT_EPOCH + arg);
+    struct tm utc;
+    struct timespec now_wall;
+    double dispatch_us;
+    const alarm_out_event_t *last;
+
+    switch (event)
+    {
+        case TRACE_CLOCK_WAKE:
+            if ((arg != reference_second())
+                    || (0 != xTaskGetTickCount() % CLOCK_PERIOD_TICKS))
+            {
+                fail("clock woke off the second boundary", arg);
+            }
+            if (arg != last_wake + 1)
+            {
+                fail("clock skipped or repeated a second", arg);
+            }
+            last_wake = arg;
+            wake_tick = xTaskGetTickCount();
+            if (arg == start_second + SIM_FLOOD_AT)
+            {
+                /**hold print_task back while the time keeps being posted*/
+                vTaskSuspend(print_handle);
+                burst_second = arg + SIM_BURST_SECONDS;
+                burst_wakes = 0;
+                flood_start(arg);
+            } else if (arg == burst_second)
+            {
+                vTaskResume(print_handle);
+            }
+#if APP_HRTIMER
+            if (arg == start_second + SIM_COUNTDOWN_AT)
+            {
+                countdowns_start(arg);
+            } else if (arg == start_second + SIM_COUNTDOWN_AT + 1)
+            {
+                countdowns_cancel(2, arg);
+            } else if (arg == start_second + SIM_COUNTDOWN_AT + SIM_COUNTDOWN_SECONDS)
+            {
+                countdowns_check(arg);
+            }
+#endif
+            clock_gettime(CLOCK_MONOTONIC, &wake_wall);
+            if ((arg % SECONDS_PER_DAY == SECONDS_PER_DAY - 1)
+                    && (day + 1 >= sim_days))
+            {
+                report_and_exit();
+            }
+        break;
+        case TRACE_PRINT_RECV:
+            print_handle = xTaskGetCurrentTaskHandle();
+            burst_wakes++;
+            /**released at the wake up of burst_second, it runs after the post*/
+            if (burst_second && (arg >= burst_second))
+            {
+                if ((arg != burst_second) || (1 != burst_wakes))
+                {
+                    fail("print_task did not take just the newest time", arg);
+                }
+                burst_second = 0;
+            }
+        break;
+        case TRACE_TIME_SENT:
+            clock_to_hms(arg, &hms);
+            snprintf(expected, sizeof(expected), "%d : %d : %d hrs", hms.hours,
+                     hms.minutes, hms.seconds);
+            if (!screen_matches(TIME_ROW, TIME_COL, expected))
+            {
+                fail("displayed time differs from the reference", arg);
+            }
+            /**the date is checked against the C library, not calendar.c*/
+            gmtime_r(&unix_time, &utc);
+            strftime(expected, sizeof(expected), "%a %Y-%m-%d", &utc);
+            if (!screen_matches(DATE_ROW, DATE_COL, expected))
+            {
+                fail("displayed date differs from the reference", arg);
+            }
+            check_zones(arg);
+        break;
+        case TRACE_ALARM_SET:
+            alarm_count++;
+            if (arg % SECONDS_PER_DAY != alarm_second)
+            {
+                fail("alarm fired at the wrong time", arg);
+            }
+            if (day == alarm_day)
+            {
+                fail("alarm fired twice in one day", arg);
+            }
+            if ((UINT32_MAX != alarm_day) && (day != alarm_day + 1))
+            {
+                fail("a day went by without an alarm", arg);
+            }
+            if (UINT32_MAX != alarm_day)
+            {
+                check_auto_stop(arg);
+            }
+            alarm_day = day;
+        break;
+        case TRACE_ALARM_RECV:
+            clock_gettime(CLOCK_MONOTONIC, &now_wall);
+            if ((arg != last_wake) || (xTaskGetTickCount() != wake_tick))
+            {
+                fail("alarm dispatched after the tick of its second", arg);
+            }
+            dispatch_us = (double)(now_wall.tv_sec - wake_wall.tv_sec) * 1e6
+                    + (double)(now_wall.tv_nsec - wake_wall.tv_nsec) / 1e3;
+            if (dispatch_us > dispatch_max_us)
+            {
+                dispatch_max_us = dispatch_us;
+            }
+        break;
+        case TRACE_ALARM_SENT:
+            if (!screen_matches(ALARM_ROW, ALARM_COL, "ALARM!"))
+            {
+                fail("alarm message not on screen", arg);
+            }
+            last = alarm_out_host_event(alarm_out_host_events() - 1U);
+            if ((ALARM_OUT_PLAYING != alarm_out_state()) || (NULL == last)
+                    || (last->ms != (uint64_t)xTaskGetTickCount() * 1000U / configTICK_RATE_HZ)
+                    || (0 == last->tone_hz))
+            {
+                fail("alarm output did not start with the alarm", arg);
+            }
+            ring_start_ms = (NULL != last) ? last->ms : 0;
+        break;
+        default:
+        break;
+    }
+}
+
+void trace_dump(void)
+{
+}
+
+void trace_timer_init(void)
+{
+}
+
+uint32_t trace_timer_read(void)
+{
+    return xTaskGetTickCount();
+}
+
+uint32_t trace_timer_ticks_per_us(void)
+{
+    return 1;
+}
+
+void console_port_init(void)
+{
+}
+
+void console_port_start(void)
+{
+    /**the modelled screen starts blank*/
+}
+
+/**moves the rows of the scrolling region up by one*/
+static void screen_scroll(void)
+{
+    memmove(screen[scroll_top], screen[scroll_top + 1],
+            (size_t)(scroll_bottom - scroll_top) * SCREEN_COLS);
+    memset(screen[scroll_bottom], ' ', SCREEN_COLS);
+    if (scroll_top < RENDER_ROWS)
+    {
+        fail("text scrolled the rows of the renderer", reference_second());
+    }
+}
+
+/**feeds one character to the VT100 model*/
+static void screen_put(char c)
+{
+    static enum { TEXT, ESCAPE, CSI } state = TEXT;
+    static int params[2];
+    static int count;
+
+    switch (state)
+    {
+        case TEXT:
+            if ('\033' == c)
+            {
+                state = ESCAPE;
+                break;
+            }
+            if (in_text && (('\r' == c) || ('\n' == c)))
+            {
+                text_line_done();
+            }
+            if ('\r' == c)
+            {
+                cursor_col = 0;
+                break;
+            }
+            if ('\n' == c)
+            {
+                if (cursor_row == scroll_bottom)
+                {
+                    screen_scroll();
+                } else if (cursor_row < SCREEN_ROWS - 1)
+                {
+                    cursor_row++;
+                }
+                break;
+            }
+            if (in_text && (cursor_row < RENDER_ROWS))
+            {
+                fail("text written into the rows of the renderer", reference_second());
+            }
+            if (in_text && (text_len < SIM_TEXT_LINE_MAX))
+            {
+                text_line[text_len++] = c;
+            }
+            if ((cursor_row < SCREEN_ROWS) && (cursor_col < SCREEN_COLS))
+            {
+                screen[cursor_row][cursor_col] = c;
+            }
+            if (cursor_col < SCREEN_COLS - 1)
+            {
+                cursor_col++;
+            }
+        break;
+        case ESCAPE:
+            state = ('[' == c) ? CSI : TEXT;
+            params[0] = 0;
+            params[1] = 0;
+            count = 0;
+            if ('7' == c)
+            {
+                saved_row = cursor_row;
+                saved_col = cursor_col;
+                in_text = 0;
+            } else if ('8' == c)
+            {
+                cursor_row = saved_row;
+                cursor_col = saved_col;
+                in_text = 1;
+            }
+        break;
+        case CSI:
+            if ((c >= '0') && (c <= '9'))
+            {
+                params[count] = params[count] * 10 + (c - '0');
+            } else if ((';' == c) && (count < 1))
+            {
+                count++;
+            } else
+            {
+                if ('H' == c)
+                {
+                    cursor_row = params[0] - 1;
+                    cursor_col = params[1] - 1;
+                } else if ('r' == c)
+                {
+                    /**the region moves the cursor home*/
+                    scroll_top = params[0] ? params[0] - 1 : 0;
+                    scroll_bottom = params[1] ? params[1] - 1 : SCREEN_ROWS - 1;
+                    cursor_row = 0;
+                    cursor_col = 0;
+                } else if (('J' == c) && (2 == params[0]))
+                {
+                    memset(screen, ' ', sizeof(screen));
+                } else if (('J' == c) && (1 == params[0]))
+                {
+                    /**from the top of the screen to the cursor, inclusive*/
+                    if (cursor_row >= SCREEN_ROWS)
+                    {
+                        memset(screen, ' ', sizeof(screen));
+                    } else
+                    {
+                        memset(screen, ' ', (size_t)cursor_row * SCREEN_COLS);
+                        memset(screen[cursor_row], ' ', (size_t)(cursor_col < SCREEN_COLS
+                                ? cursor_col + 1 : SCREEN_COLS));
+                    }
+                }
+                state = TEXT;
+            }
+        break;
+    }
+}
+
+void console_port_write(const char *data, size_t len)
+{
+    /**escape sequences may be split across chunks, so the model keeps state*/
+    while (len--)
+    {
+        if (flood_remaining)
+        {
+            flood_put(*data++);
+        } else
+        {
+            screen_put(*data++);
+        }
+    }
+}
+
+char console_port_read(void)
+{
+    char c;
+
+    /**types key_script, then there is no more keyboard*/
+    while (key_line >= SIM_KEY_LINES)
+    {
+        vTaskSuspend(NULL);
+    }
+    c = key_script[key_line].keys[key_pos++];
+    if ('\0' == c)
+    {
+        key_line++;
+        key_pos = 0;
+        c = '\r';
+    }
+    return c;
+}
+
+/**the application's main, renamed by the sim build*/
+int app_main(void);
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+    {
+        sim_days = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    start_second = calendar_to_days(YEAR_INIT, MONTH_INIT, DAY_INIT) * SECONDS_PER_DAY
+            + HMS_TO_SECONDS(HOURS_INIT, MINUTES_INIT, SECONDS_INIT);
+    last_wake = start_second;
+    memset(screen, ' ', sizeof(screen));
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    printf("simulating %lu days from %04u-%02u-%02u %02u:%02u:%02u\n",
+           (unsigned long)sim_days, YEAR_INIT, MONTH_INIT, DAY_INIT,
+           HOURS_INIT, MINUTES_INIT, SECONDS_INIT);
+    fflush(stdout);
+    return app_main();
+}
@@ -0,0 +1,243 @@
+/**
+ * @file    hrtimer.c
+ * @brief   Stopwatch, countdown list and countdown_task.
+ *
+ * The countdowns are kept in a fixed table linked into one list sorted by
+ * deadline: starting one walks the list, expiring one only takes the head,
+ * and the compare channel always holds the head's deadline. The list is
+ * shared with the compare interrupt, so it is changed in critical sections.
+ */
+
+#include "hrtimer.h"
+
+#if APP_HRTIMER
+
+#include <stdio.h>
+
+#include "task.h"
+#include "console.h"
+
+#define US_PER_SECOND 1000000U
+
+/**type definition for one countdown of the table*/
+typedef struct {
+    uint64_t deadline;  /**counter value it expires at*/
+    uint32_t expiry;    /**expiry sequence, the order the interrupt unlinked it*/
+    uint8_t next;       /**next countdown of the sorted list*/
+    bool running;
+} countdown_t;
+
+static countdown_t countdowns[HRTIMER_COUNTDOWNS];
+static uint8_t head = HRTIMER_NONE;     /**earliest deadline*/
+static uint32_t expiries;               /**countdowns expired so far*/
+static uint32_t counter_hz;
+static TaskHandle_t volatile owner;     /**countdown_task, once it runs*/
+
+/**counter values to microseconds, without overflowing the product*/
+static uint64_t counts_to_us(uint64_t counts)
+{
+    return counts / counter_hz * US_PER_SECOND
+            + counts % counter_hz * US_PER_SECOND / counter_hz;
+}
+
+/**microseconds to counter values, rounded up so nothing expires early*/
+static uint64_t us_to_counts(uint64_t us)
+{
+    return us / US_PER_SECOND * counter_hz
+            + (us % US_PER_SECOND * counter_hz + US_PER_SECOND - 1U) / US_PER_SECOND;
+}
+
+/**puts the compare channel on the head of the list, called in a critical section*/
+static void arm_head(void)
+{
+    if (HRTIMER_NONE == head)
+    {
+        hrtimer_port_disarm();
+    } else
+    {
+        hrtimer_port_arm(countdowns[head].deadline);
+    }
+}
+
+void hrtimer_init(void)
+{
+    hrtimer_port_init();
+    counter_hz = hrtimer_port_hz();
+}
+
+uint64_t hrtimer_now_us(void)
+{
+    return counts_to_us(hrtimer_port_now());
+}
+
+void hrtimer_stopwatch_start(hrtimer_stopwatch_t *stopwatch)
+{
+    if (!stopwatch->running)
+    {
+        stopwatch->start = hrtimer_port_now();
+        stopwatch->running = true;
+    }
+}
+
+void hrtimer_stopwatch_stop(hrtimer_stopwatch_t *stopwatch)
+{
+    if (stopwatch->running)
+    {
+        stopwatch->elapsed += hrtimer_port_now() - stopwatch->start;
+        stopwatch->running = false;
+    }
+}
+
+void hrtimer_stopwatch_reset(hrtimer_stopwatch_t *stopwatch)
+{
+    stopwatch->elapsed = 0;
+    stopwatch->start = hrtimer_port_now();
+}
+
+uint64_t hrtimer_stopwatch_us(const hrtimer_stopwatch_t *stopwatch)
+{
+    uint64_t counts = stopwatch->elapsed;
+
+    if (stopwatch->running)
+    {
+        counts += hrtimer_port_now() - stopwatch->start;
+    }
+    return counts_to_us(counts);
+}
+
+uint8_t hrtimer_countdown_start(uint64_t us)
+{
+    uint64_t deadline = hrtimer_port_now() + us_to_counts(us);
+    uint8_t *link;
+    uint8_t id;
+
+    taskENTER_CRITICAL();
+    for (id = 0; (id < HRTIMER_COUNTDOWNS) && countdowns[id].running; id++)
+    {
+    }
+    if (HRTIMER_COUNTDOWNS == id)
+    {
+        taskEXIT_CRITICAL();
+        return HRTIMER_NONE;
+    }
+    /**after the countdowns of the same deadline, so they expire in order*/
+    for (link = &head; (HRTIMER_NONE != *link)
+            && (countdowns[*link].deadline <= deadline);
+            link = &countdowns[*link].next)
+    {
+    }
+    countdowns[id].deadline = deadline;
+    countdowns[id].running = true;
+    countdowns[id].next = *link;
+    *link = id;
+    if (head == id)
+    {
+        arm_head();
+    }
+    taskEXIT_CRITICAL();
+    return id;
+}
+
+bool hrtimer_countdown_cancel(uint8_t id)
+{
+    uint8_t *link;
+
+    if (id >= HRTIMER_COUNTDOWNS)
+    {
+        return false;
+    }
+    taskENTER_CRITICAL();
+    if (!countdowns[id].running)
+    {
+        taskEXIT_CRITICAL();
+        return false;
+    }
+    for (link = &head; *link != id; link = &countdowns[*link].next)
+    {
+    }
+    *link = countdowns[id].next;
+    countdowns[id].running = false;
+    if (link == &head)
+    {
+        arm_head();
+    }
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+bool hrtimer_countdown_left(uint8_t id, uint64_t *us)
+{
+    uint64_t now = hrtimer_port_now();
+    uint64_t deadline;
+    bool running;
+
+    if (id >= HRTIMER_COUNTDOWNS)
+    {
+        return false;
+    }
+    taskENTER_CRITICAL();
+    running = countdowns[id].running;
+    deadline = countdowns[id].deadline;
+    taskEXIT_CRITICAL();
+    if (running)
+    {
+        *us = (deadline > now) ? counts_to_us(deadline - now) : 0;
+    }
+    return running;
+}
+
+void hrtimer_expired_from_isr(BaseType_t *higher_priority_woken)
+{
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    uint64_t now = hrtimer_port_now();
+    uint32_t done = 0;
+
+    while ((HRTIMER_NONE != head) && (countdowns[head].deadline <= now))
+    {
+        done |= 1UL << head;
+        countdowns[head].expiry = expiries++;
+        countdowns[head].running = false;
+        head = countdowns[head].next;
+    }
+    arm_head();
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+    if (done && (NULL != owner))
+    {
+        xTaskNotifyFromISR(owner, done, eSetBits, higher_priority_woken);
+    }
+}
+
+void countdown_task(void *args)
+{
+    char line[32];
+    uint32_t done;
+    uint8_t first;
+    uint8_t id;
+
+    /**the counter is not needed by the clock, it starts once the scheduler runs*/
+    hrtimer_init();
+    owner = xTaskGetCurrentTaskHandle();
+    for (;;)
+    {
+        /**one bit per countdown that expired since the last wake up*/
+        xTaskNotifyWait(0, UINT32_MAX, &done, portMAX_DELAY);
+        /**in expiry order, the deadline order, not the order of the ids*/
+        while (0 != done)
+        {
+            first = HRTIMER_NONE;
+            for (id = 0; id < HRTIMER_COUNTDOWNS; id++)
+            {
+                if ((done & (1UL << id)) && ((HRTIMER_NONE == first)
+                        || ((int32_t)(countdowns[id].expiry - countdowns[first].expiry) < 0)))
+                {
+                    first = id;
+                }
+            }
+            done &= ~(1UL << first);
+            snprintf(line, sizeof(line), "\r\ncountdown %u done\r\n", first);
+            console_put_line(line);   /**below the clock, never over it*/
+        }
+    }
+}
+
+#endif /* APP_HRTIMER */
@@ -0,0 +1,78 @@
+/**
+ * @file    hrtimer.h
+ * @brief   Stopwatch and countdown timers on a free running hardware counter.
+ *
+ * The kernel tick stays at its rate; sub-millisecond time comes from a
+ * counter of the board layer, extended to 64 bits so it never wraps.
+ * Every running countdown sits in one list sorted by deadline and only the
+ * head is armed on the single compare channel. When it expires the
+ * interrupt moves on to the next deadline and notifies countdown_task,
+ * which reports the countdowns that finished.
+ */
+
+#ifndef HRTIMER_H_
+#define HRTIMER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/**enables the stopwatch and the countdowns, 0 leaves the counter unused*/
+#ifndef APP_HRTIMER
+#define APP_HRTIMER 1
+#endif
+
+#define HRTIMER_COUNTDOWNS 8    /**countdowns running at once, 32 at most*/
+#define HRTIMER_NONE 0xFFU      /**no countdown*/
+
+/**type definition for a stopwatch, all zero is stopped at 0*/
+typedef struct {
+    uint64_t start;     /**counter value when started*/
+    uint64_t elapsed;   /**counts of the previous runs*/
+    bool running;
+} hrtimer_stopwatch_t;
+
+#if APP_HRTIMER
+
+/**starts the counter, called by countdown_task when it starts*/
+void hrtimer_init(void);
+
+/**microseconds since hrtimer_init*/
+uint64_t hrtimer_now_us(void);
+
+void hrtimer_stopwatch_start(hrtimer_stopwatch_t *stopwatch);
+void hrtimer_stopwatch_stop(hrtimer_stopwatch_t *stopwatch);
+void hrtimer_stopwatch_reset(hrtimer_stopwatch_t *stopwatch);
+/**microseconds counted by a stopwatch, running or not*/
+uint64_t hrtimer_stopwatch_us(const hrtimer_stopwatch_t *stopwatch);
+
+/**starts a countdown of us microseconds, returns its id or HRTIMER_NONE*/
+uint8_t hrtimer_countdown_start(uint64_t us);
+
+/**stops a countdown before it expires*/
+bool hrtimer_countdown_cancel(uint8_t id);
+
+/**microseconds left on a running countdown, false if it is not running*/
+bool hrtimer_countdown_left(uint8_t id, uint64_t *us);
+
+/**starts the counter and reports the countdowns that expired*/
+void countdown_task(void *args);
+
+/**called by the board layer from the compare interrupt*/
+void hrtimer_expired_from_isr(BaseType_t *higher_priority_woken);
+
+/**free running counter of the board layer, extended to 64 bits*/
+void hrtimer_port_init(void);
+uint64_t hrtimer_port_now(void);
+uint32_t hrtimer_port_hz(void);
+/**
+ * Compare interrupt at the deadline, at once if it has passed. Arming and
+ * disarming are called in a critical section or from the interrupt.
+ */
+void hrtimer_port_arm(uint64_t deadline);
+void hrtimer_port_disarm(void);
+
+#endif /* APP_HRTIMER */
+
+#endif /* HRTIMER_H_ */
@@ -0,0 +1,128 @@
+/**
+ * @file    hrtimer_ftm.c
+ * @brief   FTM0 counter and compare channel behind the stopwatch and countdowns.
+ *
+ * FTM0 counts the MCG fixed frequency clock (about 32 kHz, ~30 us per
+ * count) over its full 16 bit range and the overflow interrupt, every two
+ * seconds, extends it to 64 bits. A slow clock keeps the overflows from
+ * waking a tickless sleep more often than clock_task does. Channel 0 is a
+ * software compare without a pin: it is loaded once the armed deadline is
+ * inside the current 16 bit lap.
+ */
+
+#include "hrtimer.h"
+
+#if APP_HRTIMER
+
+#include "MK64F12.h"
+#include "task.h"
+#include "fsl_clock.h"
+
+#define FTM_COUNTS 0x10000U     /**one lap of the 16 bit counter*/
+#define FTM_MARGIN 2U           /**counts the compare needs to be seen*/
+
+static volatile uint64_t laps;  /**overflows, the upper bits of the counter*/
+static volatile uint64_t deadline;
+static volatile bool armed;
+
+void hrtimer_port_init(void)
+{
+    CLOCK_EnableClock(kCLOCK_Ftm0);
+    /**FTMEN clear: MOD and CnV writes take effect at the next count*/
+    FTM0->MODE = FTM_MODE_WPDIS_MASK;
+    FTM0->SC = 0;
+    FTM0->CNTIN = 0;
+    FTM0->MOD = FTM_COUNTS - 1U;
+    FTM0->CNT = 0;
+    FTM0->CONTROLS[0].CnSC = FTM_CnSC_MSA_MASK;  /**output compare, no output*/
+    /**the handler uses the FreeRTOS FromISR API*/
+    NVIC_SetPriority(FTM0_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY);
+    EnableIRQ(FTM0_IRQn);
+    FTM0->SC = FTM_SC_TOIE_MASK | FTM_SC_CLKS(2U) | FTM_SC_PS(0U);
+}
+
+uint32_t hrtimer_port_hz(void)
+{
+    return CLOCK_GetFixedFreqClkFreq();
+}
+
+uint64_t hrtimer_port_now(void)
+{
+    UBaseType_t saved;
+    uint64_t high;
+    uint32_t count;
+
+    /**BASEPRI masking works from the tasks and from the interrupt alike*/
+    saved = taskENTER_CRITICAL_FROM_ISR();
+    high = laps;
+    count = FTM0->CNT;
+    /**an overflow not yet handled belongs to this reading if the count is low*/
+    if ((FTM0->SC & FTM_SC_TOF_MASK) && (count < FTM_COUNTS / 2U))
+    {
+        high++;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+    return high * FTM_COUNTS + count;
+}
+
+/**loads the compare when the deadline is in this lap, pends the IRQ if it passed*/
+static void load_compare(void)
+{
+    uint64_t now = hrtimer_port_now();
+
+    if (!armed)
+    {
+        FTM0->CONTROLS[0].CnSC &= ~FTM_CnSC_CHIE_MASK;
+        return;
+    }
+    if (deadline <= now + FTM_MARGIN)
+    {
+        NVIC_SetPendingIRQ(FTM0_IRQn);
+    } else if (deadline - now < FTM_COUNTS - FTM_MARGIN)
+    {
+        FTM0->CONTROLS[0].CnV = (uint32_t)(deadline % FTM_COUNTS);
+        FTM0->CONTROLS[0].CnSC = FTM_CnSC_MSA_MASK | FTM_CnSC_CHIE_MASK;
+        /**the deadline may have been reached while the compare was written*/
+        if (hrtimer_port_now() >= deadline)
+        {
+            NVIC_SetPendingIRQ(FTM0_IRQn);
+        }
+    }
+}
+
+void hrtimer_port_arm(uint64_t at)
+{
+    deadline = at;
+    armed = true;
+    load_compare();
+}
+
+void hrtimer_port_disarm(void)
+{
+    armed = false;
+    load_compare();
+}
+
+void FTM0_IRQHandler(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (FTM0->SC & FTM_SC_TOF_MASK)
+    {
+        FTM0->SC &= ~FTM_SC_TOF_MASK;
+        laps++;
+    }
+    FTM0->CONTROLS[0].CnSC &= ~(FTM_CnSC_CHF_MASK | FTM_CnSC_CHIE_MASK);
+    if (armed && (hrtimer_port_now() >= deadline))
+    {
+        armed = false;
+        hrtimer_expired_from_isr(&woken);  /**arms the next deadline*/
+    } else
+    {
+        load_compare();
+    }
+    portYIELD_FROM_ISR(woken);
+    __DSB();
+}
+
+#endif /* APP_HRTIMER */
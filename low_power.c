@@ -0,0 +1,238 @@
+/**
+ * @file    low_power.c
+ * @brief   Tickless idle on the LPTMR.
+ *
+ * SysTick can suppress at most 2^24 cycles (~140 ms at 120 MHz), which would
+ * still wake the CPU several times per clock second. Instead the LPTMR,
+ * clocked from the 32.768 kHz ERCLK32K, times the whole idle period (up to
+ * 2 s), so the CPU wakes once per clock_task deadline or on any interrupt.
+ *
+ * Tick compensation: the time of a sleep is measured, not assumed. The
+ * LPTMR starts on an unknown phase of its clock, so the sleep is timed from
+ * its first count, and on wake up the CPU waits for the next count, so only
+ * whole counts are converted. The CPU is awake from stopping SysTick to the
+ * first count and from the last count to restarting SysTick; the DWT cycle
+ * counter times those parts, the equivalent of the stock port's
+ * ulStoppedTimerCompensation. SysTick is restarted with the leftover cycles
+ * of the current tick, and a sleep that ran past its last tick carries the
+ * excess into the next one, so the kernel tick count neither runs ahead of
+ * real time nor falls behind it, and vTaskDelayUntil keeps its period.
+ */
+
+#include "low_power.h"
+
+#include "MK64F12.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fsl_clock.h"
+#include "fsl_lptmr.h"
+
+#if APP_LOW_POWER
+
+#define LPTMR_CLOCK_HZ 32768U   /**ERCLK32K frequency*/
+#define LPTMR_MAX_COUNT 0xFFFFU /**16 bit compare register*/
+#define LPTMR_START_COUNTS 2U   /**counts the CPU may wait for the first one*/
+
+/**CPU cycles per kernel tick*/
+#define CYCLES_PER_TICK (configCPU_CLOCK_HZ / configTICK_RATE_HZ)
+
+static volatile uint32_t g_wakeups = 0;
+static uint32_t carry_cycles;   /**real time the tick count is behind*/
+
+/**converts CPU cycles to whole LPTMR counts, rounding down*/
+static uint32_t cycles_to_counts(uint64_t cycles)
+{
+    return (uint32_t)((cycles * LPTMR_CLOCK_HZ) / configCPU_CLOCK_HZ);
+}
+
+/**converts LPTMR counts back to CPU cycles*/
+static uint64_t counts_to_cycles(uint32_t counts)
+{
+    return ((uint64_t)counts * configCPU_CLOCK_HZ) / LPTMR_CLOCK_HZ;
+}
+
+void low_power_init(void)
+{
+    lptmr_config_t config;
+
+    /**ERCLK32K taken from the RTC 32.768 kHz oscillator*/
+    CLOCK_EnableClock(kCLOCK_Rtc0);
+    RTC->CR |= RTC_CR_OSCE_MASK;
+    CLOCK_SetEr32kClock(2U);
+
+    LPTMR_GetDefaultConfig(&config);
+    config.prescalerClockSource = kLPTMR_PrescalerClock_2; /**ERCLK32K*/
+    config.bypassPrescaler = true;
+    LPTMR_Init(LPTMR0, &config);
+
+    /**the cycle counter times the part of each sleep the CPU is awake*/
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    LPTMR_EnableInterrupts(LPTMR0, kLPTMR_TimerInterruptEnable);
+    NVIC_SetPriority(LPTMR0_IRQn, configLIBRARY_LOWEST_INTERRUPT_PRIORITY);
+    EnableIRQ(LPTMR0_IRQn);
+}
+
+uint32_t low_power_get_wakeups(void)
+{
+    return g_wakeups;
+}
+
+void LPTMR0_IRQHandler(void)
+{
+    /**only needed to leave WFI, the elapsed time is read back by the idle task*/
+    LPTMR_ClearStatusFlags(LPTMR0, kLPTMR_TimerCompareFlag);
+    __DSB();
+}
+
+/**
+ * Waits for the LPTMR to count once more and returns the new count; *edge
+ * gets the cycle counter at that count.
+ */
+static uint32_t wait_count(uint32_t *edge)
+{
+    uint32_t start = LPTMR_GetCurrentTimerCount(LPTMR0);
+    uint32_t now;
+
+    do
+    {
+        now = LPTMR_GetCurrentTimerCount(LPTMR0);
+    } while (now == start);
+    *edge = DWT->CYCCNT;
+    return now;
+}
+
+void vApplicationTickHook(void)
+{
+    g_wakeups++;
+}
+
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    uint64_t sleep_cycles;
+    uint64_t slept_cycles;
+    uint32_t counts;
+    uint32_t edges;
+    uint32_t tick_remaining;
+    uint32_t elapsed_in_tick;
+    uint32_t stopped_at;    /**cycle counter when SysTick stopped*/
+    uint32_t first_at;      /**cycle counter at the first LPTMR count*/
+    uint32_t last_at;       /**cycle counter at the last LPTMR count*/
+    uint32_t awake;
+    TickType_t completed;
+    uint32_t max_ticks;
+
+    max_ticks = (uint32_t)(counts_to_cycles(LPTMR_MAX_COUNT - 1U) / CYCLES_PER_TICK);
+    if (xExpectedIdleTime > max_ticks)
+    {
+        xExpectedIdleTime = max_ticks;
+    }
+
+    /**stop SysTick, what is left of the current tick is part of the sleep*/
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    stopped_at = DWT->CYCCNT;
+    tick_remaining = SysTick->VAL;
+    if (0 == tick_remaining)
+    {
+        tick_remaining = CYCLES_PER_TICK;
+    }
+
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    if (eAbortSleep == eTaskConfirmSleepModeStatus())
+    {
+        /**a task became ready, resume the tick where it would be by now*/
+        awake = DWT->CYCCNT - stopped_at;
+        tick_remaining = (awake + 2U < tick_remaining) ? tick_remaining - awake : 2U;
+        SysTick->LOAD = tick_remaining - 1U;
+        SysTick->VAL = 0U;
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        SysTick->LOAD = CYCLES_PER_TICK - 1U;
+        __enable_irq();
+        return;
+    }
+
+    /**the deadline is carry_cycles closer in real time than in ticks*/
+    sleep_cycles = (uint64_t)tick_remaining
+            + (uint64_t)(xExpectedIdleTime - 1U) * CYCLES_PER_TICK;
+    sleep_cycles -= (carry_cycles < sleep_cycles) ? carry_cycles : sleep_cycles;
+    counts = cycles_to_counts(sleep_cycles);
+    counts = (counts > LPTMR_START_COUNTS) ? counts - LPTMR_START_COUNTS : 1U;
+    /**the compare fires counts after the first count*/
+    LPTMR_SetTimerPeriod(LPTMR0, counts + 1U);
+    LPTMR_StartTimer(LPTMR0);
+    (void)wait_count(&first_at);
+
+    __DSB();
+    __WFI();
+    __ISB();
+    g_wakeups++;
+
+    /**
+     * The compare, or another interrupt, woke the CPU between two counts:
+     * the next count marks a known time. After the compare the counter
+     * restarts from zero.
+     */
+    edges = wait_count(&last_at);
+    if (LPTMR_GetStatusFlags(LPTMR0) & kLPTMR_TimerCompareFlag)
+    {
+        edges += counts;
+    } else
+    {
+        edges -= 1U;
+    }
+    LPTMR_StopTimer(LPTMR0);
+    LPTMR_ClearStatusFlags(LPTMR0, kLPTMR_TimerCompareFlag);
+
+    /**
+     * Real time since the last tick boundary: the part of the tick SysTick
+     * had counted, the time the tick count was already behind, the time
+     * awake up to the first count and the whole counts slept since.
+     */
+    slept_cycles = (uint64_t)(CYCLES_PER_TICK - tick_remaining) + carry_cycles
+            + (first_at - stopped_at) + counts_to_cycles(edges);
+    completed = (TickType_t)(slept_cycles / CYCLES_PER_TICK);
+    elapsed_in_tick = (uint32_t)(slept_cycles % CYCLES_PER_TICK);
+
+    /**plus the time awake since the last count, up to restarting SysTick*/
+    elapsed_in_tick += DWT->CYCCNT - last_at;
+    completed += elapsed_in_tick / CYCLES_PER_TICK;
+    elapsed_in_tick %= CYCLES_PER_TICK;
+    carry_cycles = 0;
+    if (completed >= xExpectedIdleTime)
+    {
+        /**
+         * The last tick is left to SysTick so the kernel never runs ahead,
+         * the pending tick fires at once and the excess is carried over.
+         */
+        carry_cycles = (completed - xExpectedIdleTime) * CYCLES_PER_TICK
+                + elapsed_in_tick;
+        completed = xExpectedIdleTime - 1U;
+        elapsed_in_tick = CYCLES_PER_TICK - 2U;
+    }
+
+    SysTick->LOAD = CYCLES_PER_TICK - elapsed_in_tick - 1U;
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = CYCLES_PER_TICK - 1U;
+
+    vTaskStepTick(completed);
+    __enable_irq();
+}
+
+#else
+
+void low_power_init(void)
+{
+}
+
+uint32_t low_power_get_wakeups(void)
+{
+    /**the 200 Hz tick wakes the CPU every time*/
+    return (uint32_t)xTaskGetTickCount();
+}
+
+#endif /* APP_LOW_POWER */
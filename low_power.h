@@ -0,0 +1,26 @@
+/**
+ * @file    low_power.h
+ * @brief   Tickless idle support: the kernel sleeps on the LPTMR until the
+ *          next task deadline instead of waking on every SysTick.
+ */
+
+#ifndef LOW_POWER_H_
+#define LOW_POWER_H_
+
+#include <stdint.h>
+
+/**enables the tickless idle mode, 0 keeps the plain 200 Hz tick*/
+#ifndef APP_LOW_POWER
+#define APP_LOW_POWER 1
+#endif
+
+/**sets up the LPTMR used to time the tickless sleeps, called before the scheduler starts*/
+void low_power_init(void);
+
+/**
+ * Number of times the CPU has been woken, either by a tick or from a
+ * tickless sleep. Without APP_LOW_POWER every tick is a wake up.
+ */
+uint32_t low_power_get_wakeups(void);
+
+#endif /* LOW_POWER_H_ */
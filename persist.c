@@ -0,0 +1,338 @@
+/**
+ * @file    persist.c
+ * @brief   Append only record log for the time base and the alarm table.
+ */
+
+#include "persist.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "clock.h"
+#include "alarm_table.h"
+#include "calendar.h"
+
+#define SLOTS_PER_SECTOR (PERSIST_SECTOR_SIZE / sizeof(persist_record_t))
+
+#define RECORD_ERASED 0xFFU /**type byte of a slot never programmed*/
+#define RECORD_HEADER 'H'   /**value is the sector sequence number*/
+#define RECORD_TIME 'T'     /**value is the clock second*/
+#define RECORD_ALARM 'A'    /**id and flags, value is the second of the day*/
+
+#define FLAG_USED (1U << 0)
+#define FLAG_ENABLED (1U << 1)
+#define FLAG_DATED (1U << 2)    /**value is the clock second it rings once*/
+
+/**a repeating alarm keeps its weekday mask above the second of the day*/
+#define WEEKDAYS_SHIFT 17U
+#define SECONDS_MASK ((1UL << WEEKDAYS_SHIFT) - 1U)
+
+/**alarm state kept per id: the record flags above the record value*/
+#define ALARM_STATE(flags, value) (((uint64_t)(flags) << 32) | (value))
+#define STATE_FLAGS(state) ((uint8_t)((state) >> 32))
+#define STATE_VALUE(state) ((uint32_t)(state))
+
+/**type definition for one log record, exactly one flash phrase*/
+typedef struct {
+    uint8_t type;
+    uint8_t id;
+    uint8_t flags;
+    uint8_t check;      /**CRC-8 of the other seven bytes*/
+    uint32_t value;
+} persist_record_t;
+
+static uint64_t saved_alarms[ALARM_TABLE_SIZE]; /**alarm states as the log has them*/
+static uint32_t sector;         /**newest sector of the ring*/
+static uint32_t sequence;       /**sequence number of the newest sector*/
+static uint32_t next_slot;      /**first free slot of the newest sector*/
+static bool have_sector;
+static TaskHandle_t persist_handle;
+
+static uint8_t record_check(const persist_record_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint8_t crc = 0;
+    size_t i;
+    int bit;
+
+    for (i = 0; i < sizeof(*record); i++)
+    {
+        if (offsetof(persist_record_t, check) == i)
+        {
+            continue;
+        }
+        crc ^= bytes[i];
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80U) ? (uint8_t)((crc << 1) ^ 0x07U) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t slot_offset(uint32_t sector_index, uint32_t slot)
+{
+    return sector_index * PERSIST_SECTOR_SIZE + slot * sizeof(persist_record_t);
+}
+
+static bool record_erased(const persist_record_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record;
+    size_t i;
+
+    for (i = 0; i < sizeof(*record); i++)
+    {
+        if (0xFFU != bytes[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool record_valid(const persist_record_t *record)
+{
+    return (RECORD_ERASED != record->type)
+            && (record_check(record) == record->check);
+}
+
+static bool record_write(uint32_t sector_index, uint32_t slot, uint8_t type,
+                         uint8_t id, uint8_t flags, uint32_t value)
+{
+    persist_record_t record;
+
+    record.type = type;
+    record.id = id;
+    record.flags = flags;
+    record.value = value;
+    record.check = record_check(&record);
+    return persist_port_program(slot_offset(sector_index, slot), &record,
+                                sizeof(record));
+}
+
+/**state of one alarm as the table has it now*/
+static uint64_t table_state(alarm_id_t id)
+{
+    alarm_t alarm;
+    uint8_t flags = FLAG_USED;
+
+    if (!alarm_table_get(id, &alarm))
+    {
+        return 0;
+    }
+    if (alarm.enabled)
+    {
+        flags |= FLAG_ENABLED;
+    }
+    if (ALARM_REPEATING != alarm.date)
+    {
+        return ALARM_STATE(flags | FLAG_DATED,
+                           alarm.date * SECONDS_PER_DAY + alarm.seconds_of_day);
+    }
+    return ALARM_STATE(flags, ((uint32_t)alarm.weekdays << WEEKDAYS_SHIFT)
+                       | alarm.seconds_of_day);
+}
+
+bool persist_init(uint32_t *clock_seconds)
+{
+    persist_record_t record;
+    bool have_time = false;
+    uint32_t i;
+
+    persist_port_init();
+    memset(saved_alarms, 0, sizeof(saved_alarms));
+    have_sector = false;
+
+    /**the newest sector is the valid header with the highest sequence*/
+    for (i = 0; i < PERSIST_SECTORS; i++)
+    {
+        persist_port_read(slot_offset(i, 0), &record, sizeof(record));
+        if (record_valid(&record) && (RECORD_HEADER == record.type)
+                && (!have_sector || ((int32_t)(record.value - sequence) > 0)))
+        {
+            sector = i;
+            sequence = record.value;
+            have_sector = true;
+        }
+    }
+    if (!have_sector)
+    {
+        return false;
+    }
+
+    /**replay the newest sector up to its first erased slot*/
+    for (next_slot = 1; next_slot < SLOTS_PER_SECTOR; next_slot++)
+    {
+        persist_port_read(slot_offset(sector, next_slot), &record,
+                          sizeof(record));
+        if (record_erased(&record))
+        {
+            break;
+        }
+        if (!record_valid(&record))
+        {
+            continue;   /**torn write, the next records are still good*/
+        }
+        if (RECORD_TIME == record.type)
+        {
+            /**that second was already polled, resume after it*/
+            *clock_seconds = record.value + 1;
+            have_time = true;
+        } else if ((RECORD_ALARM == record.type)
+                && (record.id < ALARM_TABLE_SIZE))
+        {
+            saved_alarms[record.id] = (record.flags & FLAG_USED)
+                    ? ALARM_STATE(record.flags, record.value) : 0;
+        }
+    }
+    return have_time;
+}
+
+void persist_restore_alarms(void)
+{
+    alarm_id_t id;
+    alarm_t alarm;
+    uint32_t value;
+    uint8_t flags;
+
+    /*
+     * The table hands out its own ids, so they can differ from the logged
+     * ones when the log has gaps; the first flush then logs the difference.
+     */
+    for (id = 0; id < ALARM_TABLE_SIZE; id++)
+    {
+        flags = STATE_FLAGS(saved_alarms[id]);
+        value = STATE_VALUE(saved_alarms[id]);
+        if (!(flags & FLAG_USED))
+        {
+            continue;
+        }
+        alarm.enabled = (0 != (flags & FLAG_ENABLED));
+        if (flags & FLAG_DATED)
+        {
+            alarm.date = value / SECONDS_PER_DAY;
+            alarm.seconds_of_day = value % SECONDS_PER_DAY;
+            alarm.weekdays = 0;
+        } else
+        {
+            alarm.date = ALARM_REPEATING;
+            alarm.seconds_of_day = value & SECONDS_MASK;
+            alarm.weekdays = (uint8_t)(value >> WEEKDAYS_SHIFT);
+            if (0 == alarm.weekdays)
+            {
+                alarm.weekdays = CALENDAR_EVERY_DAY;   /**logged before weekday masks*/
+            }
+        }
+        alarm_table_add(&alarm);
+    }
+}
+
+/**starts the next sector of the ring with a snapshot of the whole state*/
+static void compact(uint32_t clock_seconds)
+{
+    uint32_t target = have_sector ? (sector + 1) % PERSIST_SECTORS : 0;
+    uint32_t slot = 1;
+    uint64_t state;
+    alarm_id_t id;
+    bool ok;
+
+    if (!persist_port_erase(slot_offset(target, 0)))
+    {
+        return;     /**retried by the next flush*/
+    }
+    ok = true;
+    for (id = 0; (id < ALARM_TABLE_SIZE) && ok; id++)
+    {
+        state = table_state(id);
+        saved_alarms[id] = state;
+        if (state)
+        {
+            ok = record_write(target, slot++, RECORD_ALARM, (uint8_t)id,
+                              STATE_FLAGS(state), STATE_VALUE(state));
+        }
+    }
+    ok = ok && record_write(target, slot++, RECORD_TIME, 0, 0, clock_seconds);
+    /**the header goes last, a torn snapshot is never the newest sector*/
+    if (ok && record_write(target, 0, RECORD_HEADER, 0, 0, sequence + 1))
+    {
+        sector = target;
+        sequence++;
+        next_slot = slot;
+        have_sector = true;
+    } else
+    {
+        /**saved_alarms no longer matches the old sector, snapshot again*/
+        next_slot = SLOTS_PER_SECTOR;
+    }
+}
+
+/**appends whatever changed since the last flush, and the time*/
+static void flush(void)
+{
+    uint32_t clock_seconds = clock_now();
+    uint32_t changed = 0;
+    uint64_t state;
+    alarm_id_t id;
+
+    for (id = 0; id < ALARM_TABLE_SIZE; id++)
+    {
+        if (table_state(id) != saved_alarms[id])
+        {
+            changed++;
+        }
+    }
+    if (!have_sector || (next_slot + changed + 1 > SLOTS_PER_SECTOR))
+    {
+        compact(clock_seconds);
+        return;
+    }
+    for (id = 0; (id < ALARM_TABLE_SIZE) && (next_slot < SLOTS_PER_SECTOR); id++)
+    {
+        state = table_state(id);
+        if (state != saved_alarms[id])
+        {
+            /**a slot that failed to program is skipped as a torn record*/
+            if (record_write(sector, next_slot++, RECORD_ALARM, (uint8_t)id,
+                             STATE_FLAGS(state), STATE_VALUE(state)))
+            {
+                saved_alarms[id] = state;
+            }
+        }
+    }
+    if (next_slot < SLOTS_PER_SECTOR)
+    {
+        record_write(sector, next_slot++, RECORD_TIME, 0, 0, clock_seconds);
+    }
+}
+
+void persist_request(void)
+{
+    if (NULL != persist_handle)
+    {
+        xTaskNotifyGive(persist_handle);
+    }
+}
+
+void persist_task(void *args)
+{
+    /*
+     * Writes the time every PERSIST_PERIOD_S clock seconds. A request waits
+     * PERSIST_SETTLE_MS more so a burst of commands costs one flush, and
+     * with one record per change a sector is only erased after hundreds
+     * of flushes.
+     */
+    persist_handle = xTaskGetCurrentTaskHandle();
+    flush();
+    for (;;)
+    {
+        if (ulTaskNotifyTake(pdTRUE, CLOCK_PERIOD_TICKS * PERSIST_PERIOD_S))
+        {
+            vTaskDelay(pdMS_TO_TICKS(PERSIST_SETTLE_MS));
+            ulTaskNotifyTake(pdTRUE, 0);
+        }
+        flush();
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file    persist.h
+ * @brief   Time and alarm persistence in an append only flash log.
+ *
+ * The log spans PERSIST_SECTORS flash sectors used as a ring. Every record
+ * is one 8 byte flash phrase, programmed once and never rewritten:
+ *
+ *   slot 0       sector header, carries the sector sequence number
+ *   slots 1..n   a snapshot of every alarm in use plus the time, then
+ *                time and alarm change records appended after it
+ *
+ * When a sector fills up, the next one is erased and starts with a fresh
+ * snapshot; its header is programmed last, so an interrupted compaction
+ * leaves the previous sector as the newest. At boot only the sector
+ * headers and the newest sector are read, never the whole log.
+ *
+ * The flash itself is behind the persist_port_* functions: persist_flash.c
+ * on target and a file backed stand-in on the host.
+ */
+
+#ifndef PERSIST_H_
+#define PERSIST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef PERSIST_SECTOR_SIZE
+#define PERSIST_SECTOR_SIZE 4096U   /**MK64F12 program flash sector*/
+#endif
+#ifndef PERSIST_SECTORS
+#define PERSIST_SECTORS 8U          /**sectors in the log ring*/
+#endif
+#ifndef PERSIST_PERIOD_S
+#define PERSIST_PERIOD_S 60U        /**seconds between time records*/
+#endif
+#ifndef PERSIST_SETTLE_MS
+#define PERSIST_SETTLE_MS 2000U     /**changes requested closer than this share a write*/
+#endif
+
+/**
+ * Finds the newest sector and replays it. Returns true and the clock second
+ * after the last saved one if the log holds a state, called before the
+ * scheduler starts.
+ */
+bool persist_init(uint32_t *clock_seconds);
+
+/**adds the alarms replayed by persist_init to the (empty) alarm table*/
+void persist_restore_alarms(void);
+
+/**asks persist_task to write the current state soon, changes are batched*/
+void persist_request(void);
+
+/**appends the state changes to the log, created at a low priority*/
+void persist_task(void *args);
+
+/**prepares the flash, provided by the board layer*/
+void persist_port_init(void);
+
+/**reads len bytes at offset from the start of the log area*/
+void persist_port_read(uint32_t offset, void *data, uint32_t len);
+
+/**programs len bytes at offset, a multiple of the 8 byte phrase*/
+bool persist_port_program(uint32_t offset, const void *data, uint32_t len);
+
+/**erases the sector that starts at offset*/
+bool persist_port_erase(uint32_t offset);
+
+#endif /* PERSIST_H_ */
@@ -0,0 +1,48 @@
+/**
+ * @file    persist_flash.c
+ * @brief   Persistence log on the MK64F12 program flash.
+ *
+ * The log takes the last PERSIST_SECTORS sectors of program flash, in the
+ * second flash block, so the code keeps running from the first block while
+ * a sector is erased or programmed (read while write). The linker script
+ * must keep the application out of these sectors. Reads are plain memory
+ * reads of the mapped flash.
+ */
+
+#include "persist.h"
+
+#include <string.h>
+
+#include "fsl_flash.h"
+
+static flash_config_t flash;
+static uint32_t log_base;   /**address of the first log sector*/
+
+void persist_port_init(void)
+{
+    uint32_t flash_base;
+    uint32_t flash_size;
+
+    FLASH_Init(&flash);
+    FLASH_GetProperty(&flash, kFLASH_PropertyPflashBlockBaseAddr, &flash_base);
+    FLASH_GetProperty(&flash, kFLASH_PropertyPflashTotalSize, &flash_size);
+    log_base = flash_base + flash_size - PERSIST_SECTORS * PERSIST_SECTOR_SIZE;
+}
+
+void persist_port_read(uint32_t offset, void *data, uint32_t len)
+{
+    memcpy(data, (const void *)(log_base + offset), len);
+}
+
+bool persist_port_program(uint32_t offset, const void *data, uint32_t len)
+{
+    return kStatus_FLASH_Success
+            == FLASH_Program(&flash, log_base + offset, (uint32_t *)data, len);
+}
+
+bool persist_port_erase(uint32_t offset)
+{
+    return kStatus_FLASH_Success
+            == FLASH_Erase(&flash, log_base + offset, PERSIST_SECTOR_SIZE,
+                           kFLASH_ApiEraseKey);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file    rtc_seconds.c
+ * @brief   MK64F12 RTC seconds counter behind the RTC clock source.
+ *
+ * The RTC runs from the same 32.768 kHz oscillator as the LPTMR and keeps
+ * counting on VBAT while the MCU is reset or powered down. Its seconds
+ * interrupt also wakes the CPU from a tickless sleep.
+ */
+
+#include "clock.h"
+
+#if APP_CLOCK_RTC
+
+#include "MK64F12.h"
+#include "fsl_rtc.h"
+
+bool clock_rtc_port_init(void)
+{
+    rtc_config_t config;
+    bool kept;
+
+    RTC_GetDefaultConfig(&config);
+    RTC_Init(RTC, &config);
+    RTC->CR |= RTC_CR_OSCE_MASK;
+    /**the time is only invalid after a VBAT power on or a counter overflow*/
+    kept = !(RTC_GetStatusFlags(RTC) & (kRTC_TimeInvalidFlag | kRTC_TimeOverflowFlag));
+    RTC_EnableInterrupts(RTC, kRTC_SecondsInterruptEnable);
+    /**the handler uses the FreeRTOS FromISR API*/
+    NVIC_SetPriority(RTC_Seconds_IRQn,
+                     configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1);
+    EnableIRQ(RTC_Seconds_IRQn);
+    if (kept)
+    {
+        RTC_StartTimer(RTC);
+    }
+    return kept;
+}
+
+uint32_t clock_rtc_port_read(void)
+{
+    uint32_t seconds;
+
+    /**the counter can be read mid increment, two equal reads are stable*/
+    do
+    {
+        seconds = RTC->TSR;
+    } while (seconds != RTC->TSR);
+    return seconds;
+}
+
+void clock_rtc_port_write(uint32_t seconds)
+{
+    /**writing TSR clears the invalid flag and restarts the second*/
+    RTC_StopTimer(RTC);
+    RTC->TSR = seconds;
+    RTC_StartTimer(RTC);
+}
+
+void RTC_Seconds_IRQHandler(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    clock_rtc_second_from_isr(&woken);
+    portYIELD_FROM_ISR(woken);
+    __DSB();
+}
+
+#endif /* APP_CLOCK_RTC */
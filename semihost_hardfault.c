@@ -62,11 +62,65 @@
 // is meant as a development aid, and it is not recommended to leave
 // semihosted code in a production build of your application!
 //
+// == CRASH CAPTURE ==
+//
+// Any other hard fault is handed to crash_capture(), which seals the stacked
+// registers, the fault status registers, the running task and the recent
+// tracepoints into no-init RAM (see crash.h) and resets the MCU. The record
+// is printed by crash_report() on the next boot. With a debugger attached
+// the core halts on a breakpoint first, with the faulting frame intact.
+//
 // ****************************************************************************
 
 // Allow handler to be removed by setting a define (via command line)
 #if !defined (__SEMIHOST_HARDFAULT_DISABLE)
 
+#include <string.h>
+
+#include "MK64F12.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "crash.h"
+
+#define EXC_RETURN_PSP 0x4U     /**the fault frame is on the process stack*/
+#define EXC_RETURN_THREAD 0x8U  /**the fault was taken from thread mode*/
+
+/**seals the fault record and resets, reached from HardFault_Handler*/
+__attribute__((used, noreturn))
+void crash_capture(const uint32_t *frame, uint32_t exc_return)
+{
+    crash_record_t *record = &crash_record;
+    const char *name;
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+        record->stacked[i] = frame[i];
+    }
+    record->cfsr = SCB->CFSR;
+    record->hfsr = SCB->HFSR;
+    record->mmfar = SCB->MMFAR;
+    record->bfar = SCB->BFAR;
+    record->exc_return = exc_return;
+    /**only tasks run on the process stack, main and the ISRs use MSP*/
+    if (exc_return & EXC_RETURN_PSP)
+    {
+        name = pcTaskGetName(NULL);
+    }
+    else
+    {
+        name = (exc_return & EXC_RETURN_THREAD) ? "main" : "isr";
+    }
+    strncpy(record->task, name, CRASH_TASK_NAME);
+    crash_seal(record);
+
+    if (CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk)
+    {
+        __BKPT(0);
+    }
+    NVIC_SystemReset();
+}
+
 __attribute__((naked))
 void HardFault_Handler(void){
     __asm(  ".syntax unified\n"
@@ -82,13 +136,20 @@ void HardFault_Handler(void){
         // Load the instruction that triggered hard fault
         "_process:     \n"
             "LDR    R1,[R0,#24] \n"
+        // A PC outside the 1 MB flash is no semihosting call, and reading
+        // through it could fault again and lock the core up
+            "LSRS   R2,R1,#20 \n"
+            "BNE    _crash  \n"
             "LDRH    R2,[r1] \n"
         // Semihosting instruction is "BKPT 0xAB" (0xBEAB)
             "LDR    R3,=0xBEAB \n"
             "CMP     R2,R3 \n"
             "BEQ    _semihost_return \n"
-        // Wasn't semihosting instruction so enter infinite loop
-            "B . \n"
+        // Wasn't semihosting instruction so record the fault and reset,
+        // R0 still points to the stacked frame and LR is EXC_RETURN
+        "_crash: \n"
+            "MOV    R1, LR  \n"
+            "B      crash_capture \n"
         // Was semihosting instruction, so adjust location to
         // return to by 1 instruction (2 bytes), then exit function
         "_semihost_return: \n"
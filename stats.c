@@ -0,0 +1,101 @@
+/**
+ * @file    stats.c
+ * @brief   Run time statistics dump for the instrumentation build.
+ */
+
+#include "stats.h"
+
+#if APP_STATS
+
+#include <stdio.h>
+
+#include "task.h"
+#include "console.h"
+
+#define STATS_MAX_TASKS 10  /**tasks reported by one dump*/
+#define STATS_LINE 64       /**longest line of the dump*/
+
+/**type definition for the time spent waiting on one semaphore*/
+typedef struct {
+    uint32_t count;     /**completed takes*/
+    uint32_t total;     /**run time counter units spent waiting*/
+    uint32_t max;       /**longest single wait*/
+} stats_wait_t;
+
+static const char *const wait_names[STATS_WAIT_COUNT] = {
+    "screen"
+};
+static stats_wait_t waits[STATS_WAIT_COUNT];
+
+BaseType_t stats_semaphore_take(SemaphoreHandle_t semaphore, TickType_t timeout,
+                                stats_wait_id_t id)
+{
+    uint32_t start = stats_timer_read();
+    BaseType_t taken = xSemaphoreTake(semaphore, timeout);
+    uint32_t waited = stats_timer_read() - start;
+
+    taskENTER_CRITICAL();
+    waits[id].count++;
+    waits[id].total += waited;
+    if (waited > waits[id].max)
+    {
+        waits[id].max = waited;
+    }
+    taskEXIT_CRITICAL();
+    return taken;
+}
+
+void stats_dump(void)
+{
+    static TaskStatus_t tasks[STATS_MAX_TASKS];
+    char line[STATS_LINE];
+    UBaseType_t count;
+    UBaseType_t i;
+    uint32_t total_time;
+    console_stats_t console;
+
+    count = uxTaskGetSystemState(tasks, STATS_MAX_TASKS, &total_time);
+    total_time /= 100U; /**percentages*/
+    if (0 == total_time)
+    {
+        total_time = 1;
+    }
+
+    console_put_line("\r\ntask        cpu%  runtime    stack free\r\n");
+    for (i = 0; i < count; i++)
+    {
+        snprintf(line, sizeof(line), "%-10s %4lu %10lu %6u words\r\n",
+                 tasks[i].pcTaskName,
+                 (unsigned long)(tasks[i].ulRunTimeCounter / total_time),
+                 (unsigned long)tasks[i].ulRunTimeCounter,
+                 (unsigned)tasks[i].usStackHighWaterMark);
+        console_put_line(line);
+    }
+
+    snprintf(line, sizeof(line), "heap free %u min ever %u of %u bytes\r\n",
+             (unsigned)xPortGetFreeHeapSize(),
+             (unsigned)xPortGetMinimumEverFreeHeapSize(),
+             (unsigned)configTOTAL_HEAP_SIZE);
+    console_put_line(line);
+
+    console_get_stats(&console);
+    snprintf(line, sizeof(line), "console depth max %lu dropped %lu\r\n",
+             (unsigned long)console.high_water, (unsigned long)console.dropped);
+    console_put_line(line);
+
+    for (i = 0; i < STATS_WAIT_COUNT; i++)
+    {
+        stats_wait_t wait;
+
+        taskENTER_CRITICAL();
+        wait = waits[i];
+        taskEXIT_CRITICAL();
+        snprintf(line, sizeof(line), "wait %-8s n %lu avg %lu max %lu (1/%u s)\r\n",
+                 wait_names[i], (unsigned long)wait.count,
+                 (unsigned long)(wait.count ? wait.total / wait.count : 0),
+                 (unsigned long)wait.max, STATS_RUNTIME_HZ);
+        console_put_line(line);
+    }
+}
+
+#endif /* APP_STATS */
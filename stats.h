@@ -0,0 +1,41 @@
+/**
+ * @file    stats.h
+ * @brief   Optional instrumentation build (APP_STATS=1).
+ *
+ * Collects per task CPU time and stack high water marks from the kernel,
+ * the heap minimum ever free, the console ring depth and the time tasks
+ * spend waiting on semaphores, and dumps them on the console on demand.
+ * With APP_STATS=0 every hook compiles down to the plain kernel call.
+ */
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#define STATS_RUNTIME_HZ 10000U /**resolution of the run time counter*/
+
+/**semaphores whose wait times are measured*/
+typedef enum {
+    STATS_WAIT_SCREEN,  /**mutex_screen*/
+    STATS_WAIT_COUNT
+} stats_wait_id_t;
+
+#if APP_STATS
+
+/**takes a semaphore and accounts the time spent waiting for it*/
+BaseType_t stats_semaphore_take(SemaphoreHandle_t semaphore, TickType_t timeout,
+                                stats_wait_id_t id);
+
+/**writes the collected statistics to the console*/
+void stats_dump(void);
+
+#else
+
+#define stats_semaphore_take(semaphore, timeout, id) \
+    xSemaphoreTake((semaphore), (timeout))
+
+#endif /* APP_STATS */
+
+#endif /* STATS_H_ */
@@ -0,0 +1,41 @@
+/**
+ * @file    stats_timer.c
+ * @brief   Run time statistics counter on the PIT lifetime timer.
+ *
+ * PIT channels 0 and 1 are chained into the 64 bit lifetime timer counting
+ * bus clocks; the kernel reads it scaled down to STATS_RUNTIME_HZ so the
+ * 32 bit task counters last for days instead of seconds.
+ */
+
+#include "stats.h"
+
+#if APP_STATS
+
+#include "fsl_clock.h"
+#include "fsl_pit.h"
+
+static uint32_t bus_clocks_per_count;
+
+void stats_timer_init(void)
+{
+    pit_config_t config;
+
+    PIT_GetDefaultConfig(&config);
+    PIT_Init(PIT, &config);
+    PIT_SetTimerPeriod(PIT, kPIT_Chnl_0, 0xFFFFFFFFU);
+    PIT_SetTimerPeriod(PIT, kPIT_Chnl_1, 0xFFFFFFFFU);
+    PIT_SetTimerChainMode(PIT, kPIT_Chnl_1, true);
+    PIT_StartTimer(PIT, kPIT_Chnl_1);
+    PIT_StartTimer(PIT, kPIT_Chnl_0);
+    bus_clocks_per_count = CLOCK_GetFreq(kCLOCK_BusClk) / STATS_RUNTIME_HZ;
+}
+
+unsigned long stats_timer_read(void)
+{
+    /**the lifetime timer counts down from all ones*/
+    uint64_t elapsed = ~PIT_GetLifetimeTimerCount(PIT);
+
+    return (unsigned long)(elapsed / bus_clocks_per_count);
+}
+
+#endif /* APP_STATS */
@@ -0,0 +1,140 @@
+/**
+ * @file    timezone.c
+ * @brief   Lazily derived time zone views.
+ *
+ * A view is the clock second plus the standard offset, plus the saving
+ * when the standard time falls inside the daylight saving period of its
+ * year. Both changes of the year are found from the first day of their
+ * month with the day number arithmetic of calendar.c, no table of years
+ * is kept.
+ */
+
+#include "timezone.h"
+
+#include <stddef.h>
+#include <strings.h>
+
+#include "calendar.h"
+#include "clock.h"
+#include "app_config.h"
+
+#define SECONDS_PER_HOUR ((int32_t)TOP_MINUTES * TOP_SECONDS)
+
+/**type definition for one row of APP_TIMEZONES*/
+typedef struct {
+    const char *name;
+    int32_t offset;             /**standard time minus the clock, seconds*/
+    const timezone_dst_t *dst;  /**NULL when the zone keeps standard time*/
+} timezone_t;
+
+const timezone_dst_t timezone_dst_eu = {
+    { 3, TIMEZONE_LAST_WEEK, CALENDAR_SUNDAY, 1, true },
+    { 10, TIMEZONE_LAST_WEEK, CALENDAR_SUNDAY, 1, true },
+    SECONDS_PER_HOUR
+};
+
+const timezone_dst_t timezone_dst_us = {
+    { 3, 2, CALENDAR_SUNDAY, 2, false },
+    { 11, 1, CALENDAR_SUNDAY, 1, false },  /**02:00 summer time*/
+    SECONDS_PER_HOUR
+};
+
+#define TIMEZONE_ENTRY(name, minutes, dst) { name, (minutes) * TOP_SECONDS, dst },
+static const timezone_t zones[] = {
+    APP_TIMEZONES(TIMEZONE_ENTRY)
+};
+#undef TIMEZONE_ENTRY
+
+#define ZONE_COUNT (sizeof(zones) / sizeof(zones[0]))
+
+/**written by the command task, read by print_task, a single word*/
+static volatile uint32_t shown_mask = APP_ZONES_SHOWN;
+
+/**standard time second of a change in the given year*/
+static int64_t change_second(const timezone_change_t *change, uint16_t year,
+                             int32_t offset)
+{
+    uint32_t first = calendar_to_days(year, change->month, 1);
+    uint32_t day;
+
+    if (TIMEZONE_LAST_WEEK == change->week)
+    {
+        /**back from the first day of the next month*/
+        uint32_t next = (12 == change->month) ? calendar_to_days(year + 1, 1, 1)
+                : calendar_to_days(year, change->month + 1, 1);
+
+        day = next - 1U;
+        day -= (calendar_weekday(day) + 7U - change->weekday) % 7U;
+    } else
+    {
+        day = first + (change->weekday + 7U - calendar_weekday(first)) % 7U
+                + 7U * (change->week - 1U);
+    }
+    return (int64_t)day * SECONDS_PER_DAY
+            + (int64_t)change->hour * SECONDS_PER_HOUR
+            + (change->base ? offset : 0);
+}
+
+uint8_t timezone_count(void)
+{
+    return (uint8_t)ZONE_COUNT;
+}
+
+const char *timezone_name(uint8_t zone)
+{
+    return (zone < ZONE_COUNT) ? zones[zone].name : "";
+}
+
+uint8_t timezone_find(const char *name)
+{
+    uint8_t zone;
+
+    for (zone = 0; zone < ZONE_COUNT; zone++)
+    {
+        if (0 == strcasecmp(name, zones[zone].name))
+        {
+            return zone;
+        }
+    }
+    return TIMEZONE_NONE;
+}
+
+uint32_t timezone_local(uint8_t zone, uint32_t clock_seconds, bool *summer)
+{
+    const timezone_t *view = &zones[zone % ZONE_COUNT];
+    int64_t local = (int64_t)clock_seconds + view->offset;
+    int64_t start;
+    int64_t end;
+    calendar_date_t date;
+    bool in_dst = false;
+
+    if ((NULL != view->dst) && (local >= 0))
+    {
+        calendar_from_days((uint32_t)(local / SECONDS_PER_DAY), &date);
+        start = change_second(&view->dst->start, date.year, view->offset);
+        end = change_second(&view->dst->end, date.year, view->offset);
+        /**a southern rule starts late in the year and ends early in the next*/
+        in_dst = (start < end) ? ((local >= start) && (local < end))
+                : ((local >= start) || (local < end));
+        if (in_dst)
+        {
+            local += view->dst->save;
+        }
+    }
+    if (NULL != summer)
+    {
+        *summer = in_dst;
+    }
+    /**the views are not defined before the clock epoch*/
+    return (local < 0) ? 0U : (uint32_t)local;
+}
+
+uint32_t timezone_shown(void)
+{
+    return shown_mask;
+}
+
+void timezone_show(uint32_t mask)
+{
+    shown_mask = mask;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file    timezone.h
+ * @brief   Time zone views of the single clock time base.
+ *
+ * The clock counts the time of the base zone (UTC, unless the initial time
+ * says otherwise). A zone is only a row of the APP_TIMEZONES table of
+ * app_config.h: a name, a standard offset from the base and an optional
+ * daylight saving rule. Its local time is computed from the clock second
+ * when it is asked for, in constant time, so a zone costs no task, no
+ * stack and no work until it is shown.
+ */
+
+#ifndef TIMEZONE_H_
+#define TIMEZONE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TIMEZONE_LAST_WEEK 5    /**week of a change on the last weekday of a month*/
+#define TIMEZONE_NONE 0xFFU     /**no zone of that name*/
+
+/**type definition for the moment a daylight saving period starts or ends*/
+typedef struct {
+    uint8_t month;      /**1 to 12*/
+    uint8_t week;       /**1 to 4, or TIMEZONE_LAST_WEEK*/
+    uint8_t weekday;    /**calendar_weekday_t*/
+    uint8_t hour;       /**of local standard time, or of the base time*/
+    bool base;          /**hour counts in the base time instead*/
+} timezone_change_t;
+
+/**type definition for a daylight saving rule*/
+typedef struct {
+    timezone_change_t start;
+    timezone_change_t end;
+    int32_t save;       /**seconds added during the period*/
+} timezone_dst_t;
+
+/**EU rule: last Sunday of March to last Sunday of October, 01:00 UTC*/
+extern const timezone_dst_t timezone_dst_eu;
+/**US rule: second Sunday of March 02:00 to first Sunday of November 02:00*/
+extern const timezone_dst_t timezone_dst_us;
+
+/**number of zones of APP_TIMEZONES*/
+uint8_t timezone_count(void);
+
+/**short name of a zone*/
+const char *timezone_name(uint8_t zone);
+
+/**zone of a name, case insensitive, or TIMEZONE_NONE*/
+uint8_t timezone_find(const char *name);
+
+/**local time of a zone at a clock second, summer tells if DST applies*/
+uint32_t timezone_local(uint8_t zone, uint32_t clock_seconds, bool *summer);
+
+/**mask of the zones print_task shows, bit n is zone n*/
+uint32_t timezone_shown(void);
+void timezone_show(uint32_t mask);
+
+#endif /* TIMEZONE_H_ */
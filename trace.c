@@ -0,0 +1,196 @@
+/**
+ * @file    trace.c
+ * @brief   Tracepoint buffer and end to end latency histograms.
+ *
+ * The dump is plain text so a host side analyzer can parse it:
+ *   H <path> <count> <min> <avg> <p99> <max>   latencies in us
+ *   B <path> <bucket> <count>                  bucket b holds [2^b, 2^(b+1)) us
+ *   T <timestamp> <event> <arg>                raw records, oldest first
+ */
+
+#include "trace.h"
+
+#if APP_TRACE
+
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "console.h"
+
+#define TRACE_LINE 64   /**longest line of the dump*/
+
+typedef struct {
+    uint32_t timestamp;
+    uint32_t arg;
+    uint8_t event;
+} trace_record_t;
+
+/**type definition for one end to end latency histogram*/
+typedef struct {
+    uint32_t start;     /**timestamp of the pending start event*/
+    uint32_t start_arg; /**arg the end event has to match*/
+    uint8_t pending;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t buckets[TRACE_BUCKETS];
+} trace_histogram_t;
+
+static trace_record_t records[TRACE_BUFFER_SIZE];
+static uint32_t record_count;   /**records ever written*/
+static trace_histogram_t histograms[TRACE_PATH_COUNT];
+
+static void histogram_add(trace_histogram_t *histogram, uint32_t us)
+{
+    uint8_t bucket = 0;
+
+    while ((bucket < TRACE_BUCKETS - 1) && (us >> (bucket + 1)))
+    {
+        bucket++;
+    }
+    histogram->buckets[bucket]++;
+    if ((0 == histogram->count) || (us < histogram->min))
+    {
+        histogram->min = us;
+    }
+    if (us > histogram->max)
+    {
+        histogram->max = us;
+    }
+    histogram->total += us;
+    histogram->count++;
+}
+
+static void path_start(trace_path_t path, uint32_t timestamp, uint32_t arg)
+{
+    histograms[path].start = timestamp;
+    histograms[path].start_arg = arg;
+    histograms[path].pending = 1;
+}
+
+static void path_end(trace_path_t path, uint32_t timestamp, uint32_t arg)
+{
+    trace_histogram_t *histogram = &histograms[path];
+
+    if (histogram->pending && (histogram->start_arg == arg))
+    {
+        histogram->pending = 0;
+        histogram_add(histogram, (timestamp - histogram->start)
+                / trace_timer_ticks_per_us());
+    }
+}
+
+void trace_point(trace_event_t event, uint32_t arg)
+{
+    trace_record_t *record;
+    uint32_t timestamp;
+
+    crash_event(event, arg);
+    taskENTER_CRITICAL();
+    timestamp = trace_timer_read();
+    record = &records[record_count % TRACE_BUFFER_SIZE];
+    record->timestamp = timestamp;
+    record->arg = arg;
+    record->event = event;
+    record_count++;
+
+    switch (event)
+    {
+        case TRACE_CLOCK_WAKE:
+            path_start(TRACE_PATH_DISPLAY, timestamp, arg);
+            path_start(TRACE_PATH_DISPATCH, timestamp, arg);
+        break;
+        case TRACE_TIME_SENT:
+            path_end(TRACE_PATH_DISPLAY, timestamp, arg);
+        break;
+        case TRACE_ALARM_SET:
+            path_start(TRACE_PATH_ALARM, timestamp, arg);
+        break;
+        case TRACE_ALARM_RECV:
+            path_end(TRACE_PATH_DISPATCH, timestamp, arg);
+        break;
+        case TRACE_ALARM_SENT:
+            path_end(TRACE_PATH_ALARM, timestamp, arg);
+        break;
+        default:
+        break;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**latency under which 99% of the samples fall, to bucket resolution*/
+static uint32_t histogram_p99(const trace_histogram_t *histogram)
+{
+    uint32_t target = histogram->count - histogram->count / 100U;
+    uint32_t seen = 0;
+    uint8_t bucket;
+
+    for (bucket = 0; bucket < TRACE_BUCKETS; bucket++)
+    {
+        seen += histogram->buckets[bucket];
+        if (seen >= target)
+        {
+            break;
+        }
+    }
+    /**upper edge of the bucket, but never past the real maximum*/
+    if ((bucket >= TRACE_BUCKETS - 1) || ((2U << bucket) > histogram->max))
+    {
+        return histogram->max;
+    }
+    return 2U << bucket;
+}
+
+void trace_dump(void)
+{
+    static trace_histogram_t histogram;
+    static trace_record_t record;
+    char line[TRACE_LINE];
+    uint32_t first;
+    uint32_t last;
+    uint8_t path;
+    uint8_t bucket;
+
+    console_put_line("\r\n");
+    for (path = 0; path < TRACE_PATH_COUNT; path++)
+    {
+        taskENTER_CRITICAL();
+        histogram = histograms[path];
+        taskEXIT_CRITICAL();
+        snprintf(line, sizeof(line), "H %u %lu %lu %lu %lu %lu\r\n", path,
+                 (unsigned long)histogram.count, (unsigned long)histogram.min,
+                 (unsigned long)(histogram.count ?
+                         histogram.total / histogram.count : 0),
+                 (unsigned long)(histogram.count ? histogram_p99(&histogram) : 0),
+                 (unsigned long)histogram.max);
+        console_put_line(line);
+        for (bucket = 0; bucket < TRACE_BUCKETS; bucket++)
+        {
+            if (histogram.buckets[bucket])
+            {
+                snprintf(line, sizeof(line), "B %u %u %lu\r\n", path, bucket,
+                         (unsigned long)histogram.buckets[bucket]);
+                console_put_line(line);
+            }
+        }
+    }
+
+    taskENTER_CRITICAL();
+    last = record_count;
+    taskEXIT_CRITICAL();
+    first = (last > TRACE_BUFFER_SIZE) ? last - TRACE_BUFFER_SIZE : 0;
+    for (; first < last; first++)
+    {
+        taskENTER_CRITICAL();
+        record = records[first % TRACE_BUFFER_SIZE];
+        taskEXIT_CRITICAL();
+        snprintf(line, sizeof(line), "T %lu %u %lu\r\n",
+                 (unsigned long)record.timestamp, record.event,
+                 (unsigned long)record.arg);
+        console_put_line(line);
+    }
+}
+
+#endif /* APP_TRACE */
@@ -0,0 +1,65 @@
+/**
+ * @file    trace.h
+ * @brief   Optional latency tracing build (APP_TRACE=1).
+ *
+ * Tracepoints store a timestamped record in a fixed size RAM buffer and
+ * feed two latency histograms: second boundary to the time being sent out
+ * of the UART, and alarm firing to "ALARM!" being sent out of the UART.
+ * With APP_TRACE=0 a tracepoint is reduced to its crash breadcrumb.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+
+#include "crash.h"
+
+#ifndef APP_TRACE
+#define APP_TRACE 0
+#endif
+
+#define TRACE_BUFFER_SIZE 256   /**records kept, the oldest are overwritten*/
+#define TRACE_BUCKETS 24        /**log2 microsecond histogram buckets*/
+
+/**tracepoints*/
+typedef enum {
+    TRACE_CLOCK_WAKE,   /**clock_task woke at a second boundary, arg: clock second*/
+    TRACE_TIME_POST,    /**time posted to the print mailbox, arg: clock second*/
+    TRACE_PRINT_RECV,   /**print_task took the time, arg: clock second*/
+    TRACE_TIME_SENT,    /**time left the UART, arg: clock second*/
+    TRACE_ALARM_SET,    /**alarm fired by clock_task, arg: clock second*/
+    TRACE_ALARM_RECV,   /**alarm_task woke for the alarm, arg: clock second*/
+    TRACE_ALARM_SENT,   /**"ALARM!" left the UART, arg: clock second*/
+    TRACE_EVENT_COUNT
+} trace_event_t;
+
+/**measured end to end paths*/
+typedef enum {
+    TRACE_PATH_DISPLAY, /**TRACE_CLOCK_WAKE to TRACE_TIME_SENT*/
+    TRACE_PATH_ALARM,   /**TRACE_ALARM_SET to TRACE_ALARM_SENT*/
+    TRACE_PATH_DISPATCH,/**TRACE_CLOCK_WAKE to TRACE_ALARM_RECV, alarm dispatch*/
+    TRACE_PATH_COUNT
+} trace_path_t;
+
+#if APP_TRACE
+
+/**records a tracepoint and updates the latency of the path it ends*/
+void trace_point(trace_event_t event, uint32_t arg);
+
+/**writes the histograms and the raw records to the console*/
+void trace_dump(void);
+
+/**free running trace timestamp and its rate, provided by the board layer*/
+void trace_timer_init(void);
+uint32_t trace_timer_read(void);
+uint32_t trace_timer_ticks_per_us(void);
+
+#else
+
+/**only the crash breadcrumb is left*/
+#define trace_point(event, arg) crash_event((event), (arg))
+
+#endif /* APP_TRACE */
+
+#endif /* TRACE_H_ */
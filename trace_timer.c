@@ -0,0 +1,38 @@
+/**
+ * @file    trace_timer.c
+ * @brief   Trace timestamps from a free running PIT channel.
+ *
+ * The DWT cycle counter stops while the core sleeps in tickless idle, so
+ * PIT channel 2 counts the bus clock instead; it keeps running in wait mode
+ * and wraps every ~71 s at 60 MHz, far longer than any traced latency.
+ */
+
+#include "trace.h"
+
+#if APP_TRACE
+
+#include "fsl_clock.h"
+#include "fsl_pit.h"
+
+void trace_timer_init(void)
+{
+    pit_config_t config;
+
+    PIT_GetDefaultConfig(&config);
+    PIT_Init(PIT, &config);
+    PIT_SetTimerPeriod(PIT, kPIT_Chnl_2, 0xFFFFFFFFU);
+    PIT_StartTimer(PIT, kPIT_Chnl_2);
+}
+
+uint32_t trace_timer_read(void)
+{
+    /**the PIT counts down, the trace wants time going up*/
+    return ~PIT_GetCurrentTimerCount(PIT, kPIT_Chnl_2);
+}
+
+uint32_t trace_timer_ticks_per_us(void)
+{
+    return CLOCK_GetFreq(kCLOCK_BusClk) / 1000000U;
+}
+
+#endif /* APP_TRACE */
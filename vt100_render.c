@@ -0,0 +1,160 @@
+/**
+ * @file    vt100_render.c
+ * @brief   Differential VT100 screen renderer.
+ */
+
+#include "vt100_render.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**resending this many unchanged cells is cheaper than a cursor move*/
+#define RENDER_MAX_GAP 3
+/**longest cursor position command, "\033[rr;ccH"*/
+#define RENDER_CUP_MAX 8
+
+static char frame[RENDER_ROWS][RENDER_COLS];    /**what the tasks want shown*/
+static char shadow[RENDER_ROWS][RENDER_COLS];   /**what the terminal shows*/
+static uint8_t cursor_row;  /**0-based terminal cursor, valid while cursor_known*/
+static uint8_t cursor_col;
+static uint8_t cursor_known;
+static uint8_t erase_pending;   /**the terminal has to be erased first*/
+static uint8_t flush_cut;       /**the last flush ran out of room*/
+static uint32_t bytes_sent;
+
+size_t vt100_render_init(char *out, size_t size)
+{
+    memset(frame, ' ', sizeof(frame));
+    vt100_render_invalidate();
+    return vt100_render_flush(out, size);
+}
+
+void vt100_render_invalidate(void)
+{
+    memset(shadow, ' ', sizeof(shadow));
+    cursor_known = 0;
+    erase_pending = 1;
+}
+
+size_t vt100_render_text_area(char *out, size_t size, uint8_t row)
+{
+    int len;
+
+    /**scrolling region from row to the bottom, then the saved text cursor*/
+    len = snprintf(out, size, "\033[%ur\033[%u;1H\0337", row, row);
+    if ((len < 0) || ((size_t)len >= size))
+    {
+        return 0;
+    }
+    cursor_known = 0;
+    bytes_sent += (uint32_t)len;
+    return (size_t)len;
+}
+
+size_t vt100_render_text(char *out, size_t size, const char *text)
+{
+    int len;
+
+    if (size <= RENDER_TEXT_FRAME)
+    {
+        return 0;
+    }
+    len = snprintf(out, size, "\0338%.*s\0337", (int)(size - RENDER_TEXT_FRAME - 1U),
+                   text);
+    return (len < 0) ? 0 : (size_t)len;
+}
+
+void vt100_render_line(uint8_t row, uint8_t col, const char *text)
+{
+    uint8_t c;
+
+    if ((row < 1) || (row > RENDER_ROWS) || (col < 1) || (col > RENDER_COLS))
+    {
+        return;
+    }
+    row--;
+    for (c = col - 1; c < RENDER_COLS; c++)
+    {
+        frame[row][c] = *text ? *text++ : ' ';
+    }
+}
+
+size_t vt100_render_flush(char *out, size_t size)
+{
+    size_t len = 0;
+    uint8_t row;
+    uint8_t col;
+    int erase;
+
+    flush_cut = 1;
+    if (erase_pending)
+    {
+        /**erase from the top of the screen to just below the managed rows*/
+        erase = snprintf(out, size, "\033[%u;1H\033[1J", RENDER_ROWS + 1U);
+        if ((erase < 0) || ((size_t)erase >= size))
+        {
+            return 0;
+        }
+        len = (size_t)erase;
+        erase_pending = 0;
+    }
+    for (row = 0; row < RENDER_ROWS; row++)
+    {
+        for (col = 0; col < RENDER_COLS; col++)
+        {
+            uint8_t gap;
+
+            if (frame[row][col] == shadow[row][col])
+            {
+                continue;
+            }
+            gap = col - cursor_col;
+            if (!cursor_known || (cursor_row != row) || (col < cursor_col)
+                    || (gap > RENDER_MAX_GAP))
+            {
+                if (len + RENDER_CUP_MAX + 1 > size)
+                {
+                    goto done;
+                }
+                len += (size_t)snprintf(&out[len], size - len, "\033[%u;%uH",
+                                        row + 1U, col + 1U);
+                cursor_row = row;
+                cursor_col = col;
+                cursor_known = 1;
+            } else
+            {
+                /**close gap: resend the few unchanged cells in between*/
+                if (len + gap + 1 > size)
+                {
+                    goto done;
+                }
+                memcpy(&out[len], &shadow[row][cursor_col], gap);
+                len += gap;
+                cursor_col = col;
+            }
+            out[len++] = frame[row][col];
+            shadow[row][col] = frame[row][col];
+            if (cursor_col < RENDER_COLS - 1)
+            {
+                cursor_col++;
+            } else
+            {
+                cursor_known = 0;   /**the terminal may wrap or stick at the margin*/
+            }
+        }
+    }
+    flush_cut = 0;
+done:
+    bytes_sent += len;
+    return len;
+}
+
+bool vt100_render_pending(void)
+{
+    return flush_cut;
+}
+
+uint32_t vt100_render_bytes(void)
+{
+    return bytes_sent;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file    vt100_render.h
+ * @brief   Differential VT100 screen renderer.
+ *
+ * Tasks draw into a frame buffer; vt100_render_flush() compares it with a
+ * shadow copy of what the terminal shows and produces only the escape
+ * sequences and characters of the cells that changed, ready for one UART
+ * write. The renderer is not locked; callers share it under mutex_screen.
+ *
+ * Other text, such as command replies, goes to a scrolling area below the
+ * managed rows through vt100_render_text(), so it never overwrites a cell
+ * or scrolls the managed rows away.
+ */
+
+#ifndef VT100_RENDER_H_
+#define VT100_RENDER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RENDER_ROWS 12  /**rows of the managed screen area*/
+#define RENDER_COLS 40  /**columns of the managed screen area*/
+
+/**
+ * Output buffer of one flush. It has to fit in the console ring, so a full
+ * repaint (up to RENDER_ROWS * (RENDER_COLS + 8) bytes) takes two flushes.
+ */
+#define RENDER_OUT_MAX 256
+#define RENDER_TEXT_FRAME 4     /**restore and save cursor commands around a text*/
+
+/**
+ * Clears the frame and writes the command erasing the managed rows to out,
+ * returns its length. The rows below, such as a crash report, are kept.
+ */
+size_t vt100_render_init(char *out, size_t size);
+
+/**
+ * Forgets what the terminal shows, after output the renderer did not
+ * produce or bytes that never reached the terminal: the next flush erases
+ * the managed rows and redraws every cell that is not blank.
+ */
+void vt100_render_invalidate(void);
+
+/**
+ * Writes the commands making the rows from row down a scrolling area, with
+ * its text cursor at the top, to out and returns their length.
+ */
+size_t vt100_render_text_area(char *out, size_t size, uint8_t row);
+
+/**
+ * Writes text to out framed for the scrolling area: it starts where the
+ * previous text ended and the text cursor is saved after it. Returns the
+ * length, text that does not fit is cut.
+ */
+size_t vt100_render_text(char *out, size_t size, const char *text);
+
+/**draws text at a 1-based row and column and blanks the rest of the row*/
+void vt100_render_line(uint8_t row, uint8_t col, const char *text);
+
+/**
+ * Writes the changes since the last flush to out and returns its length.
+ * If out is too small, the cells left over stay pending for the next flush.
+ */
+size_t vt100_render_flush(char *out, size_t size);
+
+/**true when the last flush left changes pending for lack of room*/
+bool vt100_render_pending(void);
+
+/**total bytes produced by the renderer since start up*/
+uint32_t vt100_render_bytes(void);
+
+#endif /* VT100_RENDER_H_ */